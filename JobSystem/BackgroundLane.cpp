@@ -0,0 +1,187 @@
+#include "BackgroundLane.h"
+#include <new>
+
+// 当前线程正在执行的时间片，供检查点判断
+struct BackgroundSlice {
+	BackgroundTask* task;
+	BackgroundPreemptFunction preempt;
+	void* context;
+	std::chrono::steady_clock::time_point begin;
+	std::chrono::steady_clock::time_point end;
+	uint64_t budgetLeftNanos;        // 开始时本帧剩余预算，UINT64_MAX 表示不限
+	bool preempted;
+};
+
+static thread_local BackgroundSlice* tlslice = nullptr;
+
+void BackgroundLane::Configure(uint32_t maxWorkers, uint32_t frameBudgetMicros, uint32_t sliceMicros)
+{
+	this->maxWorkers = maxWorkers;
+	frameBudgetNanos = static_cast<uint64_t>(frameBudgetMicros) * 1000;
+	sliceNanos = static_cast<uint64_t>(sliceMicros > 0 ? sliceMicros : 1) * 1000;
+	frameUsedNanos = 0;
+}
+
+BackgroundTask* BackgroundLane::Submit(BackgroundTaskFunction func, void* userData)
+{
+	BackgroundTask* task = new (std::nothrow) BackgroundTask();
+	if (!task) return nullptr;
+	task->func = func;
+	task->userData = userData;
+	task->state.store(BACKGROUND_TASK_QUEUED, std::memory_order_relaxed);
+	task->cancelRequested.store(false, std::memory_order_relaxed);
+	task->references.store(2, std::memory_order_relaxed);
+	task->runNanos = 0;
+	task->slices = 0;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	tasks.push_back(task);
+	queuedCount.fetch_add(1, std::memory_order_release);
+	return task;
+}
+
+bool BackgroundLane::HasBudget() const
+{
+	return frameBudgetNanos == 0 || frameUsedNanos.load(std::memory_order_relaxed) < frameBudgetNanos;
+}
+
+void BackgroundLane::Release(BackgroundTask* task)
+{
+	if (task->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		delete task;
+	}
+}
+
+void BackgroundLane::Finish(BackgroundTask* task, int state)
+{
+	task->state.store(state, std::memory_order_release);
+	if (state == BACKGROUND_TASK_DONE) {
+		completedTasks.fetch_add(1, std::memory_order_relaxed);
+	}
+	Release(task);
+}
+
+bool BackgroundLane::RunSlice(BackgroundPreemptFunction preempt, void* context, bool drain)
+{
+	if (!HasWork() || (!drain && !HasBudget())) {
+		return false;
+	}
+
+	// 占用一个执行名额
+	uint32_t current = running.load(std::memory_order_relaxed);
+	do {
+		if (!drain && maxWorkers > 0 && current >= maxWorkers) {
+			return false;
+		}
+	} while (!running.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel));
+
+	BackgroundTask* task = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!tasks.empty()) {
+			task = tasks.front();
+			tasks.pop_front();
+			queuedCount.fetch_sub(1, std::memory_order_release);
+		}
+	}
+	if (!task) {
+		running.fetch_sub(1, std::memory_order_release);
+		return false;
+	}
+
+	bool done = false;
+	int finalState = BACKGROUND_TASK_DONE;
+	if (task->cancelRequested.load(std::memory_order_relaxed)) {
+		finalState = BACKGROUND_TASK_CANCELLED;
+		done = true;
+	} else {
+		const uint64_t used = frameUsedNanos.load(std::memory_order_relaxed);
+		BackgroundSlice slice;
+		slice.task = task;
+		slice.preempt = drain ? nullptr : preempt;
+		slice.context = context;
+		slice.begin = std::chrono::steady_clock::now();
+		slice.end = drain ? std::chrono::steady_clock::time_point::max() : slice.begin + std::chrono::nanoseconds(sliceNanos);
+		slice.budgetLeftNanos = drain || frameBudgetNanos == 0 ? UINT64_MAX : (used < frameBudgetNanos ? frameBudgetNanos - used : 0);
+		slice.preempted = false;
+
+		BackgroundSlice* outer = tlslice;
+		tlslice = &slice;
+		done = task->func(task->userData) != 0;
+		tlslice = outer;
+
+		const uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - slice.begin).count());
+		task->runNanos += elapsed;
+		task->slices++;
+		frameUsedNanos.fetch_add(elapsed, std::memory_order_relaxed);
+		slices.fetch_add(1, std::memory_order_relaxed);
+		if (slice.preempted) {
+			preemptions.fetch_add(1, std::memory_order_relaxed);
+		}
+		if (!done && task->cancelRequested.load(std::memory_order_relaxed)) {
+			finalState = BACKGROUND_TASK_CANCELLED;
+			done = true;
+		}
+	}
+
+	if (done) {
+		Finish(task, finalState);
+	} else {
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(task);
+		queuedCount.fetch_add(1, std::memory_order_release);
+	}
+	running.fetch_sub(1, std::memory_order_release);
+	return true;
+}
+
+bool BackgroundLane::ShouldYield()
+{
+	BackgroundSlice* slice = tlslice;
+	if (!slice) {
+		return false;
+	}
+	if (slice->task->cancelRequested.load(std::memory_order_relaxed)) {
+		return true;
+	}
+
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (now >= slice->end) {
+		return true;
+	}
+	if (slice->budgetLeftNanos != UINT64_MAX &&
+		static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - slice->begin).count()) >= slice->budgetLeftNanos) {
+		return true;
+	}
+	if (slice->preempt && slice->preempt(slice->context)) {
+		slice->preempted = true;
+		return true;
+	}
+	return false;
+}
+
+void BackgroundLane::CancelAll()
+{
+	std::deque<BackgroundTask*> cancelled;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		cancelled.swap(tasks);
+		queuedCount.store(0, std::memory_order_release);
+	}
+	for (BackgroundTask* task : cancelled) {
+		Finish(task, BACKGROUND_TASK_CANCELLED);
+	}
+}
+
+void BackgroundLane::GetStats(BackgroundStats* stats) const
+{
+	if (!stats) return;
+
+	stats->queuedTasks = queuedCount.load(std::memory_order_relaxed);
+	stats->runningSlices = running.load(std::memory_order_relaxed);
+	stats->completedTasks = completedTasks.load(std::memory_order_relaxed);
+	stats->slices = slices.load(std::memory_order_relaxed);
+	stats->preemptions = preemptions.load(std::memory_order_relaxed);
+	stats->frameBudgetUsedMicros = frameUsedNanos.load(std::memory_order_relaxed) / 1000;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+// ====== 后台通道 ======
+// 跨多帧的长任务（导航网格重建、纹理转码等）不作为 Job 提交，而是按时间片轮流执行：
+// - 任务函数每次被调用执行一段工作，返回非 0 表示完成，返回 0 表示让出（进度由任务自己保存在 userData 中）
+// - 任务在检查点调用 BackgroundLane::ShouldYield()，时间片用完、本帧预算用完、有帧 Job 到达或被取消时让出
+// - 工作线程只在取不到帧 Job 时执行时间片，同时执行时间片的线程数不超过 maxWorkers
+// 任务对象不在每帧轮换的 Job 缓冲中，跨任意多帧有效
+
+// 返回非 0 表示任务完成（与 C API 的回调类型一致）
+typedef int (*BackgroundTaskFunction)(void* userData);
+// 有帧 Job 等待执行时返回 true（检查点据此让出）
+typedef bool (*BackgroundPreemptFunction)(void* context);
+
+enum BackgroundTaskState {
+	BACKGROUND_TASK_QUEUED = 0,
+	BACKGROUND_TASK_DONE = 1,
+	BACKGROUND_TASK_CANCELLED = 2
+};
+
+// 提交方和后台通道各持有一份引用，两边都释放后删除
+struct BackgroundTask {
+	BackgroundTaskFunction func;
+	void* userData;
+	std::atomic<int> state;
+	std::atomic<bool> cancelRequested;
+	std::atomic<int> references;
+	uint64_t runNanos;               // 累计执行时间，只由正在执行它的线程写入
+	uint32_t slices;
+};
+
+// 统计快照
+struct BackgroundStats {
+	uint32_t queuedTasks;
+	uint32_t runningSlices;
+	uint64_t completedTasks;
+	uint64_t slices;                 // 累计时间片数
+	uint64_t preemptions;            // 因帧 Job 到达而让出的次数
+	uint64_t frameBudgetUsedMicros;  // 本帧已用的预算
+};
+
+class BackgroundLane {
+public:
+	BackgroundLane() : maxWorkers(1), frameBudgetNanos(0), sliceNanos(1000000), queuedCount(0), running(0),
+		frameUsedNanos(0), completedTasks(0), slices(0), preemptions(0) {}
+
+	// maxWorkers 为 0 表示不限；frameBudgetMicros 为 0 表示不限
+	void Configure(uint32_t maxWorkers, uint32_t frameBudgetMicros, uint32_t sliceMicros);
+	// 内存不足时返回 nullptr
+	BackgroundTask* Submit(BackgroundTaskFunction func, void* userData);
+	bool HasWork() const { return queuedCount.load(std::memory_order_acquire) > 0; }
+	bool IsRunning() const { return running.load(std::memory_order_acquire) > 0; }
+	// 本帧预算是否还有剩余（不限时总是 true）
+	bool HasBudget() const;
+	// 现在调用 RunSlice 是否可能执行（有任务、有预算、有名额），空闲线程据此决定是否停驻
+	bool CanRunSlice() const
+	{
+		return HasWork() && HasBudget() && (maxWorkers == 0 || running.load(std::memory_order_relaxed) < maxWorkers);
+	}
+
+	// 执行一个时间片，没有可执行的任务（或名额、预算不足）时返回 false
+	// drain 为 true 时忽略名额、预算和时间片（关闭时排空）
+	bool RunSlice(BackgroundPreemptFunction preempt, void* context, bool drain = false);
+	// 帧开始：重置本帧预算
+	void FrameStart() { frameUsedNanos.store(0, std::memory_order_relaxed); }
+	// 取消所有排队的任务
+	void CancelAll();
+	void GetStats(BackgroundStats* stats) const;
+
+	// 检查点：当前线程不在时间片内时返回 false
+	static bool ShouldYield();
+
+	static void Cancel(BackgroundTask* task) { task->cancelRequested.store(true, std::memory_order_relaxed); }
+	static int GetState(const BackgroundTask* task) { return task->state.load(std::memory_order_acquire); }
+	// 提交方放弃句柄；之后不能再访问 task
+	static void Release(BackgroundTask* task);
+
+private:
+	void Finish(BackgroundTask* task, int state);
+
+	uint32_t maxWorkers;
+	uint64_t frameBudgetNanos;
+	uint64_t sliceNanos;
+
+	std::mutex mutex;
+	std::deque<BackgroundTask*> tasks;           // 轮转：时间片结束未完成的任务回到队尾
+	std::atomic<uint32_t> queuedCount;
+	std::atomic<uint32_t> running;
+	std::atomic<uint64_t> frameUsedNanos;
+	std::atomic<uint64_t> completedTasks;
+	std::atomic<uint64_t> slices;
+	std::atomic<uint64_t> preemptions;
+
+	BackgroundLane(const BackgroundLane&) = delete;
+	BackgroundLane& operator=(const BackgroundLane&) = delete;
+};
@@ -0,0 +1,381 @@
+#include "CpuTopology.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#include <malloc.h>
+#elif defined(__linux__)
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+static constexpr size_t LOCAL_MEMORY_ALIGNMENT = 64;
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// ====== sysfs 读取 ======
+
+static bool ReadInt(const std::string& path, int* value) {
+	FILE* file = fopen(path.c_str(), "r");
+	if (!file) return false;
+	const bool ok = fscanf(file, "%d", value) == 1;
+	fclose(file);
+	return ok;
+}
+
+// 解析 "0-3,8,10-11" 格式的 CPU 列表
+static std::vector<int> ReadCpuList(const std::string& path) {
+	std::vector<int> result;
+	FILE* file = fopen(path.c_str(), "r");
+	if (!file) return result;
+
+	char buffer[4096];
+	const bool ok = fgets(buffer, sizeof(buffer), file) != nullptr;
+	fclose(file);
+	if (!ok) return result;
+
+	const char* p = buffer;
+	while (*p) {
+		char* end = nullptr;
+		const long first = strtol(p, &end, 10);
+		if (end == p) break;
+		long last = first;
+		p = end;
+		if (*p == '-') {
+			last = strtol(p + 1, &end, 10);
+			p = end;
+		}
+		for (long cpu = first; cpu <= last; cpu++) {
+			result.push_back(static_cast<int>(cpu));
+		}
+		if (*p == ',') p++;
+		else break;
+	}
+	return result;
+}
+
+#if defined(__linux__)
+// 把 cpu_capacity（已是 0~1024）或最高频率换算为"最快 CPU = 1024"；缺失时视为同构
+static void NormalizeCapacity(std::vector<CpuInfo>& cpus, bool fromFrequency) {
+	int maxValue = 0;
+	for (const CpuInfo& info : cpus) {
+		maxValue = std::max(maxValue, info.capacity);
+	}
+	for (CpuInfo& info : cpus) {
+		if (maxValue <= 0 || info.capacity <= 0) {
+			info.capacity = 1024;
+		} else if (fromFrequency || maxValue != 1024) {
+			info.capacity = static_cast<int>(static_cast<int64_t>(info.capacity) * 1024 / maxValue);
+		}
+	}
+}
+
+// cpuN 目录下的 nodeX 链接给出所属 NUMA 节点
+static int ReadNode(const std::string& cpuDir) {
+	DIR* dir = opendir(cpuDir.c_str());
+	if (!dir) return -1;
+
+	int node = -1;
+	while (dirent* entry = readdir(dir)) {
+		if (strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+			node = atoi(entry->d_name + 4);
+			break;
+		}
+	}
+	closedir(dir);
+	return node;
+}
+
+// 找到 level 为 3 的缓存，返回共享它的最小 CPU 编号
+static int ReadL3(const std::string& cpuDir) {
+	for (int index = 0; index < 8; index++) {
+		const std::string cacheDir = cpuDir + "/cache/index" + std::to_string(index);
+		int level = 0;
+		if (!ReadInt(cacheDir + "/level", &level)) continue;
+		if (level != 3) continue;
+
+		const std::vector<int> shared = ReadCpuList(cacheDir + "/shared_cpu_list");
+		if (!shared.empty()) return *std::min_element(shared.begin(), shared.end());
+	}
+	return -1;
+}
+#endif
+
+void CpuTopology::Load(const char* sysfsRoot)
+{
+	cpus.clear();
+
+#if defined(__linux__)
+	const std::string root = sysfsRoot ? sysfsRoot : JOBSYSTEM_CPU_SYSFS_ROOT;
+	bool capacityFromFrequency = true;
+	for (int cpu : ReadCpuList(root + "/online")) {
+		const std::string cpuDir = root + "/cpu" + std::to_string(cpu);
+		CpuInfo info;
+		info.cpu = cpu;
+		if (!ReadInt(cpuDir + "/topology/physical_package_id", &info.package)) info.package = 0;
+		if (!ReadInt(cpuDir + "/topology/core_id", &info.core)) info.core = cpu;
+		info.node = ReadNode(cpuDir);
+		info.l3 = ReadL3(cpuDir);
+		// 缺失的层级退化到上一级：无 NUMA 信息视为按封装划分，无 L3 信息视为整个封装共享
+		if (info.node < 0) info.node = info.package;
+		if (info.l3 < 0) info.l3 = -1 - info.package;
+		// 先记录原始值，全部读完后再归一化
+		if (ReadInt(cpuDir + "/cpu_capacity", &info.capacity)) {
+			capacityFromFrequency = false;
+		} else if (!ReadInt(cpuDir + "/cpufreq/cpuinfo_max_freq", &info.capacity)) {
+			info.capacity = 0;
+		}
+		cpus.push_back(info);
+	}
+	NormalizeCapacity(cpus, capacityFromFrequency);
+#else
+	(void)sysfsRoot;
+#endif
+
+	if (cpus.empty()) {
+		const int count = std::max(1u, std::thread::hardware_concurrency());
+		for (int cpu = 0; cpu < count; cpu++) {
+			CpuInfo info = { cpu, 0, cpu, 0, 0, 1024 };
+			cpus.push_back(info);
+		}
+	}
+}
+
+const CpuInfo* CpuTopology::Find(int cpu) const
+{
+	for (const CpuInfo& info : cpus) {
+		if (info.cpu == cpu) return &info;
+	}
+	return nullptr;
+}
+
+std::vector<int> CpuTopology::AssignThreads(int threadCount, int mainCpu) const
+{
+	std::vector<int> result;
+	if (threadCount <= 0 || cpus.empty()) return result;
+
+	const CpuInfo* mainInfo = Find(mainCpu);
+	if (!mainInfo) mainInfo = &cpus[0];
+
+	// 排序：主线程所在 L3 优先，其次同节点，然后按 (节点, L3, 核, CPU) 聚集；
+	// 同一 L3 内先铺满不同物理核，再使用超线程兄弟
+	std::vector<CpuInfo> order(cpus);
+	std::stable_sort(order.begin(), order.end(), [mainInfo](const CpuInfo& a, const CpuInfo& b) {
+		const int da = a.l3 == mainInfo->l3 ? 0 : (a.node == mainInfo->node ? 1 : 2);
+		const int db = b.l3 == mainInfo->l3 ? 0 : (b.node == mainInfo->node ? 1 : 2);
+		if (da != db) return da < db;
+		if (a.node != b.node) return a.node < b.node;
+		if (a.l3 != b.l3) return a.l3 < b.l3;
+		if (a.capacity != b.capacity) return a.capacity > b.capacity;
+		return a.cpu < b.cpu;
+	});
+
+	// 每个 L3 组内：先取各物理核的第一个逻辑 CPU，再取剩余的超线程
+	std::vector<int> sequence;
+	size_t groupBegin = 0;
+	while (groupBegin < order.size()) {
+		size_t groupEnd = groupBegin;
+		while (groupEnd < order.size() && order[groupEnd].l3 == order[groupBegin].l3) groupEnd++;
+
+		std::vector<int> siblings;
+		std::vector<std::pair<int, int>> seenCores;
+		for (size_t i = groupBegin; i < groupEnd; i++) {
+			const std::pair<int, int> core(order[i].package, order[i].core);
+			if (std::find(seenCores.begin(), seenCores.end(), core) == seenCores.end()) {
+				seenCores.push_back(core);
+				sequence.push_back(order[i].cpu);
+			} else {
+				siblings.push_back(order[i].cpu);
+			}
+		}
+		sequence.insert(sequence.end(), siblings.begin(), siblings.end());
+		groupBegin = groupEnd;
+	}
+
+	// 主线程固定占用 mainCpu，工作线程跳过它
+	result.push_back(mainInfo->cpu);
+	std::vector<int> workers;
+	for (int cpu : sequence) {
+		if (cpu != mainInfo->cpu) workers.push_back(cpu);
+	}
+	if (workers.empty()) workers.push_back(mainInfo->cpu);
+
+	for (int i = 1; i < threadCount; i++) {
+		result.push_back(workers[(i - 1) % workers.size()]);
+	}
+	return result;
+}
+
+int CpuTopology::Distance(int cpuA, int cpuB) const
+{
+	const CpuInfo* a = Find(cpuA);
+	const CpuInfo* b = Find(cpuB);
+	if (!a || !b) return STEAL_DISTANCE_REMOTE;
+	if (a->l3 == b->l3) return STEAL_DISTANCE_L3;
+	if (a->node == b->node) return STEAL_DISTANCE_NODE;
+	return STEAL_DISTANCE_REMOTE;
+}
+
+bool CpuTopology::IsHeterogeneous() const
+{
+	// 只按阈值判断：同构 CPU 退回按频率换算时，睿频偏好核的最高频率略有差异，不算大小核
+	bool hasBig = false;
+	bool hasLittle = false;
+	for (const CpuInfo& info : cpus) {
+		if (IsBigCore(info.cpu)) {
+			hasBig = true;
+		} else {
+			hasLittle = true;
+		}
+	}
+	return hasBig && hasLittle;
+}
+
+bool CpuTopology::IsBigCore(int cpu) const
+{
+	const CpuInfo* info = Find(cpu);
+	return !info || info->capacity * 100 >= 1024 * BIG_CORE_CAPACITY_PERCENT;
+}
+
+int CpuTopology::CurrentCpu()
+{
+#if defined(_WIN32) || defined(_WIN64)
+	return static_cast<int>(GetCurrentProcessorNumber());
+#elif defined(__linux__)
+	return sched_getcpu();
+#else
+	return -1;
+#endif
+}
+
+bool CpuTopology::PinCurrentThread(int cpu)
+{
+	if (cpu < 0) return false;
+
+#if defined(_WIN32) || defined(_WIN64)
+	if (cpu >= 64) return false;
+	return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu) != 0;
+#elif defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+	return false;
+#endif
+}
+
+bool CpuTopology::PinCurrentThreadToClass(bool big) const
+{
+#if defined(_WIN32) || defined(_WIN64)
+	DWORD_PTR mask = 0;
+	for (const CpuInfo& info : cpus) {
+		if (info.cpu < 64 && IsBigCore(info.cpu) == big) {
+			mask |= static_cast<DWORD_PTR>(1) << info.cpu;
+		}
+	}
+	return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	int count = 0;
+	for (const CpuInfo& info : cpus) {
+		if (info.cpu >= 0 && info.cpu < CPU_SETSIZE && IsBigCore(info.cpu) == big) {
+			CPU_SET(info.cpu, &set);
+			count++;
+		}
+	}
+	return count > 0 && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+	(void)big;
+	return false;
+#endif
+}
+
+// ====== 本地内存 ======
+
+void* AllocateLocalMemory(size_t bytes, bool hugePages)
+{
+	if (bytes == 0) return nullptr;
+	void* memory = nullptr;
+
+#if defined(__linux__)
+	if (hugePages) {
+		// 多映射一个大页再裁掉首尾，得到 2MB 对齐的区域，透明大页才能生效
+		const size_t size = (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+		char* raw = static_cast<char*>(mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+		                                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+		if (raw == MAP_FAILED) {
+			// 退回普通页：返回的地址保证不在 2MB 边界上，FreeLocalMemory 据此区分；
+			// 相对 posix_memalign 结果的偏移（64 或 128）记录在返回地址的前一个字节
+			void* fallback = nullptr;
+			if (posix_memalign(&fallback, LOCAL_MEMORY_ALIGNMENT, bytes + 2 * LOCAL_MEMORY_ALIGNMENT) != 0) return nullptr;
+			size_t offset = LOCAL_MEMORY_ALIGNMENT;
+			if (((reinterpret_cast<uintptr_t>(fallback) + offset) & (HUGE_PAGE_SIZE - 1)) == 0) {
+				offset += LOCAL_MEMORY_ALIGNMENT;
+			}
+			memory = static_cast<char*>(fallback) + offset;
+			static_cast<uint8_t*>(memory)[-1] = static_cast<uint8_t>(offset / LOCAL_MEMORY_ALIGNMENT);
+			memset(memory, 0, bytes);
+			return memory;
+		}
+
+		const uintptr_t aligned = (reinterpret_cast<uintptr_t>(raw) + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+		char* begin = reinterpret_cast<char*>(aligned);
+		const size_t head = static_cast<size_t>(begin - raw);
+		if (head > 0) munmap(raw, head);
+		const size_t tail = HUGE_PAGE_SIZE - head;
+		if (tail > 0) munmap(begin + size, tail);
+
+		madvise(begin, size, MADV_HUGEPAGE);
+		memset(begin, 0, size);
+		return begin;
+	}
+	if (posix_memalign(&memory, LOCAL_MEMORY_ALIGNMENT, bytes) != 0) return nullptr;
+#elif defined(_WIN32) || defined(_WIN64)
+	(void)hugePages;
+	memory = _aligned_malloc(bytes, LOCAL_MEMORY_ALIGNMENT);
+	if (!memory) return nullptr;
+#else
+	(void)hugePages;
+	if (posix_memalign(&memory, LOCAL_MEMORY_ALIGNMENT, bytes) != 0) return nullptr;
+#endif
+
+	// 由调用线程首次写入，页面分配在该线程所在节点
+	memset(memory, 0, bytes);
+	return memory;
+}
+
+void FreeLocalMemory(void* memory, size_t bytes, bool hugePages)
+{
+	if (!memory) return;
+
+#if defined(__linux__)
+	if (hugePages) {
+		// 大页映射失败时退回的普通页（见 AllocateLocalMemory）
+		if (reinterpret_cast<uintptr_t>(memory) & (HUGE_PAGE_SIZE - 1)) {
+			const size_t offset = static_cast<uint8_t*>(memory)[-1] * LOCAL_MEMORY_ALIGNMENT;
+			free(static_cast<char*>(memory) - offset);
+			return;
+		}
+		const size_t size = (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+		munmap(memory, size);
+		return;
+	}
+	free(memory);
+#elif defined(_WIN32) || defined(_WIN64)
+	(void)bytes;
+	(void)hugePages;
+	_aligned_free(memory);
+#else
+	(void)bytes;
+	(void)hugePages;
+	free(memory);
+#endif
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// sysfs CPU 目录，可在编译时替换（如测试用的模拟目录）
+#ifndef JOBSYSTEM_CPU_SYSFS_ROOT
+#define JOBSYSTEM_CPU_SYSFS_ROOT "/sys/devices/system/cpu"
+#endif
+
+// 逻辑 CPU 的拓扑信息
+// Linux 从 /sys/devices/system/cpu 读取；其他平台或读取失败时所有 CPU 视为同一个域
+struct CpuInfo {
+	int cpu;         // 逻辑 CPU 编号
+	int package;     // 物理封装
+	int core;        // 物理核（封装内编号）
+	int node;        // NUMA 节点
+	int l3;          // 共享同一 L3 的 CPU 中编号最小者，用作 L3 标识
+	int capacity;    // 相对性能，最快的 CPU 为 1024（cpu_capacity 或最高频率换算）
+};
+
+// 相对性能不低于最快 CPU 的该比例时视为大核
+static constexpr int BIG_CORE_CAPACITY_PERCENT = 80;
+
+// 窃取距离分级：同 L3 -> 同 NUMA 节点 -> 更远
+static constexpr int STEAL_DISTANCE_L3 = 0;
+static constexpr int STEAL_DISTANCE_NODE = 1;
+static constexpr int STEAL_DISTANCE_REMOTE = 2;
+static constexpr int STEAL_DISTANCE_COUNT = 3;
+
+class CpuTopology {
+public:
+	void Load(const char* sysfsRoot = JOBSYSTEM_CPU_SYSFS_ROOT);
+	const std::vector<CpuInfo>& GetCpus() const { return cpus; }
+	const CpuInfo* Find(int cpu) const;
+
+	// 为 threadCount 个线程分配 CPU：线程 0（调用线程）使用 mainCpu，
+	// 其余线程从 mainCpu 所在 L3 开始，按 L3 / 节点聚集的顺序依次分配（线程多于 CPU 时循环），
+	// 同一 L3 内大核优先
+	std::vector<int> AssignThreads(int threadCount, int mainCpu) const;
+
+	// 两个 CPU 的窃取距离（STEAL_DISTANCE_*）
+	int Distance(int cpuA, int cpuB) const;
+
+	// 同时存在大核和小核（性能低于最快 CPU 的 BIG_CORE_CAPACITY_PERCENT）
+	bool IsHeterogeneous() const;
+	bool IsBigCore(int cpu) const;
+
+	// 当前线程所在 CPU（未知时返回 -1）
+	static int CurrentCpu();
+	// 把当前线程绑定到 cpu，失败或平台不支持时返回 false
+	static bool PinCurrentThread(int cpu);
+	// 把当前线程限制在所有大核（big 为 true）或所有小核上，由系统在同类 CPU 间调度
+	bool PinCurrentThreadToClass(bool big) const;
+
+private:
+	std::vector<CpuInfo> cpus;
+};
+
+// 按 64 字节对齐分配并由调用线程清零（first-touch：页面落在调用线程所在的 NUMA 节点）
+// hugePages 为 true 时在 Linux 上按 2MB 对齐并请求透明大页，映射失败时退回普通页
+// （释放时传入相同的 hugePages）；普通页也分配失败时返回 nullptr
+void* AllocateLocalMemory(size_t bytes, bool hugePages);
+void FreeLocalMemory(void* memory, size_t bytes, bool hugePages);
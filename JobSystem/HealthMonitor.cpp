@@ -0,0 +1,158 @@
+#include "HealthMonitor.h"
+
+void HealthMonitor::Configure(const JobSystemConfig& config, const ThreadHeartbeat* heartbeatArray, int count,
+	HealthCounterFunction counters, void* context)
+{
+	heartbeats = heartbeatArray;
+	threadCount = count;
+	counterFunc = counters;
+	counterContext = context;
+	intervalMicros = config.healthIntervalMicros;
+	longJobMicros = config.healthLongJobMicros;
+	waitTimeoutMicros = config.healthWaitTimeoutMicros;
+	stallMicros = config.healthStallMicros;
+	queueGrowthSamples = config.healthQueueGrowthSamples;
+}
+
+void HealthMonitor::SetCallback(JobHealthCallback func, void* userData)
+{
+	{
+		std::lock_guard<std::mutex> lock(callbackMutex);
+		callback = func;
+		callbackUserData = userData;
+	}
+
+	std::lock_guard<std::mutex> lock(threadMutex);
+	if (func && intervalMicros > 0 && !thread.joinable()) {
+		stopRequested = false;
+		thread = std::thread(&HealthMonitor::ThreadFunction, this);
+	}
+}
+
+void HealthMonitor::Stop()
+{
+	std::thread stopping;
+	{
+		std::lock_guard<std::mutex> lock(threadMutex);
+		stopRequested = true;
+		stopping.swap(thread);
+	}
+	threadCondition.notify_all();
+	if (stopping.joinable()) {
+		stopping.join();
+	}
+}
+
+void HealthMonitor::ThreadFunction()
+{
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	samples.assign(threadCount, ThreadSample());
+	uint64_t queued = 0;
+	counterFunc(counterContext, &queued, &lastExecuted);
+	lastPending = queued > lastExecuted ? queued - lastExecuted : 0;
+	growthSamples = 0;
+	growthStart = start;
+	growthReported = false;
+	lastProgress = start;
+	stallReported = false;
+
+	const std::chrono::microseconds interval(intervalMicros);
+	std::unique_lock<std::mutex> lock(threadMutex);
+	while (!stopRequested) {
+		threadCondition.wait_for(lock, interval);
+		if (stopRequested) {
+			break;
+		}
+		lock.unlock();
+		Sample(std::chrono::steady_clock::now());
+		lock.lock();
+	}
+}
+
+void HealthMonitor::Sample(std::chrono::steady_clock::time_point now)
+{
+	uint64_t queued = 0;
+	uint64_t executed = 0;
+	counterFunc(counterContext, &queued, &executed);
+	// 各线程的计数不是同一时刻读取的，已完成数可能暂时超过已提交数
+	const uint64_t pending = queued > executed ? queued - executed : 0;
+
+	// 长 Job / 等待：序号与上次采样相同说明还是同一个 Job / 同一次等待，从第一次看到它开始计时
+	bool running = false;
+	for (int i = 0; i < threadCount; i++) {
+		const ThreadHeartbeat& heartbeat = heartbeats[i];
+		ThreadSample& sample = samples[i];
+
+		const uint64_t jobSequence = heartbeat.jobSequence.load(std::memory_order_acquire);
+		const JobFunction jobFunction = heartbeat.jobFunction.load(std::memory_order_relaxed);
+		void* const jobData = heartbeat.jobData.load(std::memory_order_relaxed);
+		running = running || jobFunction != nullptr;
+		if (!jobFunction) {
+			sample.jobSequence = 0;
+		} else if (jobSequence != sample.jobSequence) {
+			sample.jobSequence = jobSequence;
+			sample.jobSeen = now;
+			sample.jobReported = false;
+		} else if (!sample.jobReported && longJobMicros > 0 &&
+			now - sample.jobSeen >= std::chrono::microseconds(longJobMicros)) {
+			sample.jobReported = true;
+			Report(JOB_HEALTH_LONG_JOB, i, jobFunction, jobData, now - sample.jobSeen, pending);
+		}
+
+		const uint64_t waitSequence = heartbeat.waitSequence.load(std::memory_order_acquire);
+		const JobFunction waitFunction = heartbeat.waitFunction.load(std::memory_order_relaxed);
+		if (!waitFunction) {
+			sample.waitSequence = 0;
+		} else if (waitSequence != sample.waitSequence) {
+			sample.waitSequence = waitSequence;
+			sample.waitSeen = now;
+			sample.waitReported = false;
+		} else if (!sample.waitReported && waitTimeoutMicros > 0 &&
+			now - sample.waitSeen >= std::chrono::microseconds(waitTimeoutMicros)) {
+			sample.waitReported = true;
+			Report(JOB_HEALTH_WAIT_TIMEOUT, i, waitFunction, nullptr, now - sample.waitSeen, pending);
+		}
+	}
+
+	// 队列增长：未完成数回落时重新计数
+	if (pending > lastPending) {
+		if (growthSamples++ == 0) {
+			growthStart = now;
+		}
+		if (!growthReported && queueGrowthSamples > 0 && growthSamples >= queueGrowthSamples) {
+			growthReported = true;
+			Report(JOB_HEALTH_QUEUE_GROWTH, -1, nullptr, nullptr, now - growthStart, pending);
+		}
+	} else if (pending < lastPending) {
+		growthSamples = 0;
+		growthReported = false;
+	}
+	lastPending = pending;
+
+	// 停滞：有 Job 完成、有线程正在执行 Job（执行过久由长 Job 报告）或没有未完成的 Job 都算正常
+	if (executed != lastExecuted || running || pending == 0) {
+		lastExecuted = executed;
+		lastProgress = now;
+		stallReported = false;
+	} else if (!stallReported && stallMicros > 0 && now - lastProgress >= std::chrono::microseconds(stallMicros)) {
+		stallReported = true;
+		Report(JOB_HEALTH_STALL, -1, nullptr, nullptr, now - lastProgress, pending);
+	}
+}
+
+void HealthMonitor::Report(JobHealthEventType type, int threadIndex, JobFunction function, void* data,
+	std::chrono::steady_clock::duration duration, uint64_t pendingJobs)
+{
+	JobHealthEvent event;
+	event.type = type;
+	event.threadIndex = threadIndex;
+	event.function = function;
+	event.data = data;
+	event.durationMicros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+	event.pendingJobs = pendingJobs;
+
+	std::lock_guard<std::mutex> lock(callbackMutex);
+	if (callback) {
+		callback(&event, callbackUserData);
+	}
+}
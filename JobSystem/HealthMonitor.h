@@ -0,0 +1,128 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Job.h"
+#include "JobSystemConfig.h"
+
+// ====== 调度健康监视 ======
+// 独立的监视线程按固定间隔采样每个线程的心跳和全局提交 / 完成计数，发现以下情况时回调：
+// - 长 Job：某线程上同一个最外层 Job 执行超过 longJobMicros（嵌套执行时只看最外层）
+// - 等待超时：某线程的最外层等待（WaitJob / WaitAll / WaitAny）超过 waitTimeoutMicros
+// - 队列增长：未完成的 Job 数连续 queueGrowthSamples 次采样增长
+// - 停滞：有未完成的 Job，但 stallMicros 内既没有 Job 完成、也没有线程在执行 Job（工作线程全部退出、Job 丢失）
+// 每次异常只报告一次：同一个 Job / 等待不重复报告，未完成数回落、重新有 Job 完成后才再次报告
+// 时间由监视线程的采样得出，被监视的线程只做几次 relaxed 写入，不读时钟
+
+// 每个线程的心跳（只由所属线程写入，填充到一条缓存行）
+struct ThreadHeartbeat {
+	std::atomic<uint64_t> jobSequence;      // 最外层 Job 开始执行的次数
+	std::atomic<JobFunction> jobFunction;   // 正在执行的最外层 Job 函数，nullptr 表示不在 Job 中
+	std::atomic<void*> jobData;
+	std::atomic<uint64_t> waitSequence;     // 最外层等待开始的次数
+	std::atomic<JobFunction> waitFunction;  // 正在等待的第一个 Job 的函数，nullptr 表示不在等待
+	uint32_t jobDepth;                      // 嵌套深度，只由所属线程读写
+	uint32_t waitDepth;
+	char padding[64 - sizeof(std::atomic<uint64_t>) * 5 - sizeof(uint32_t) * 2];
+
+	ThreadHeartbeat() : jobSequence(0), jobFunction(nullptr), jobData(nullptr), waitSequence(0), waitFunction(nullptr),
+		jobDepth(0), waitDepth(0), padding() {}
+
+	void BeginJob(JobFunction func, void* data)
+	{
+		if (jobDepth++ != 0) return;
+		jobData.store(data, std::memory_order_relaxed);
+		jobFunction.store(func, std::memory_order_relaxed);
+		jobSequence.store(jobSequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+	void EndJob()
+	{
+		if (--jobDepth == 0) jobFunction.store(nullptr, std::memory_order_relaxed);
+	}
+	// 替换报告的函数和数据（适配层用真实回调替换适配函数），只对最外层 Job 生效
+	void AnnotateJob(JobFunction func, void* data)
+	{
+		if (jobDepth != 1) return;
+		jobData.store(data, std::memory_order_relaxed);
+		jobFunction.store(func, std::memory_order_relaxed);
+	}
+	void BeginWait(JobFunction func)
+	{
+		if (waitDepth++ != 0) return;
+		waitFunction.store(func, std::memory_order_relaxed);
+		waitSequence.store(waitSequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+	void EndWait()
+	{
+		if (--waitDepth == 0) waitFunction.store(nullptr, std::memory_order_relaxed);
+	}
+};
+
+// 读取全局计数：已提交 / 已完成的 Job 总数
+typedef void (*HealthCounterFunction)(void* context, uint64_t* queued, uint64_t* executed);
+
+class HealthMonitor {
+public:
+	HealthMonitor() : heartbeats(nullptr), threadCount(0), counterFunc(nullptr), counterContext(nullptr),
+		intervalMicros(0), longJobMicros(0), waitTimeoutMicros(0), stallMicros(0), queueGrowthSamples(0),
+		callback(nullptr), callbackUserData(nullptr), stopRequested(false) {}
+	~HealthMonitor() { Stop(); }
+
+	// 监视线程运行期间 heartbeats 和 counterFunc 必须保持有效
+	void Configure(const JobSystemConfig& config, const ThreadHeartbeat* heartbeats, int threadCount,
+		HealthCounterFunction counterFunc, void* counterContext);
+	// 设置回调（nullptr 清除），第一次设置非空回调时启动监视线程（采样间隔为 0 时不启动）
+	// 返回后旧回调不会再被调用；回调在监视线程上执行，不能在回调中调用 SetCallback
+	void SetCallback(JobHealthCallback callback, void* userData);
+	// 停止并等待监视线程退出
+	void Stop();
+
+private:
+	// 监视线程上每个线程的采样状态
+	struct ThreadSample {
+		uint64_t jobSequence;
+		std::chrono::steady_clock::time_point jobSeen;
+		bool jobReported;
+		uint64_t waitSequence;
+		std::chrono::steady_clock::time_point waitSeen;
+		bool waitReported;
+	};
+
+	void ThreadFunction();
+	void Sample(std::chrono::steady_clock::time_point now);
+	void Report(JobHealthEventType type, int threadIndex, JobFunction function, void* data,
+		std::chrono::steady_clock::duration duration, uint64_t pendingJobs);
+
+	const ThreadHeartbeat* heartbeats;
+	int threadCount;
+	HealthCounterFunction counterFunc;
+	void* counterContext;
+	uint32_t intervalMicros;
+	uint32_t longJobMicros;
+	uint32_t waitTimeoutMicros;
+	uint32_t stallMicros;
+	uint32_t queueGrowthSamples;
+
+	std::mutex callbackMutex;
+	JobHealthCallback callback;
+	void* callbackUserData;
+
+	std::mutex threadMutex;
+	std::condition_variable threadCondition;
+	std::thread thread;
+	bool stopRequested;
+
+	// 以下只由监视线程访问
+	std::vector<ThreadSample> samples;
+	uint64_t lastPending;
+	uint32_t growthSamples;
+	std::chrono::steady_clock::time_point growthStart;
+	bool growthReported;
+	uint64_t lastExecuted;
+	std::chrono::steady_clock::time_point lastProgress;
+	bool stallReported;
+};
@@ -9,12 +9,26 @@ typedef void (*JobFunction)(Job* job, void* data);
 // 每个 Job 最多支持的 continuation 数量
 static constexpr size_t MAX_JOB_CONTINUATIONS = 10;
 
+// Job 完成时 continuationCount 被置为该值（封口），之后添加的 continuation 直接运行
+static constexpr int32_t JOB_CONTINUATIONS_SEALED = 0x40000000;
+
+// Job 标志位
+static constexpr uint32_t JOB_FLAG_CANCELLED = 1u << 0;       // 已取消，对整个子树生效
+static constexpr uint32_t JOB_FLAG_RUN_ON_CANCEL = 1u << 1;   // 取消后仍调用函数（函数自行检查取消并释放资源）
+static constexpr uint32_t JOB_FLAG_MAIN_THREAD = 1u << 2;     // 只在主线程执行，不进入工作线程的窃取队列
+static constexpr uint32_t JOB_FLAG_LATENCY_CRITICAL = 1u << 3; // 调度提示：优先在大核执行（子 Job 继承）
+static constexpr uint32_t JOB_FLAG_THROUGHPUT = 1u << 4;       // 调度提示：优先在小核执行（子 Job 继承）
+static constexpr uint32_t JOB_FLAG_HINT_MASK = JOB_FLAG_LATENCY_CRITICAL | JOB_FLAG_THROUGHPUT;
+static constexpr uint32_t JOB_FLAG_FRAME_MEMORY = 1u << 5;    // 分配在帧缓冲上（帧栅栏及其子孙，子 Job 继承）
+
 // Job 结构体大小：128 字节（两个缓存行）
 static constexpr size_t JOB_SIZE = 128;
 static constexpr size_t DATA_SIZE = sizeof(JobFunction) + sizeof(Job*) +
 sizeof(std::atomic<int32_t>) * 2 +
 sizeof(void*) +
-sizeof(Job*) * MAX_JOB_CONTINUATIONS;
+sizeof(std::atomic<Job*>) * MAX_JOB_CONTINUATIONS +
+sizeof(std::atomic<uint32_t>) +
+sizeof(uint32_t) * 2;
 
 
 struct Job {
@@ -23,6 +37,9 @@ struct Job {
 	std::atomic<int32_t> _unfinishedJob;            // 4 bytes
 	std::atomic<int32_t> continuationCount;         // 4 bytes
 	void* data;                                      // 8 bytes
-	Job* continuations[MAX_JOB_CONTINUATIONS];      // 80 bytes
-	char padding[JOB_SIZE - DATA_SIZE];             // 16 bytes
+	std::atomic<Job*> continuations[MAX_JOB_CONTINUATIONS]; // 80 bytes
+	std::atomic<uint32_t> flags;                    // 4 bytes
+	uint32_t captureId;                             // 4 bytes 图捕获编号，0 表示未捕获
+	uint32_t priority;                              // 4 bytes 关键路径优先级（剩余路径长度），0 表示普通 Job
+	char padding[JOB_SIZE - DATA_SIZE];             // 4 bytes
 };
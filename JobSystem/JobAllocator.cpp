@@ -1,26 +1,68 @@
 #include "JobAllocator.h"
+#include "CpuTopology.h"
 #include <cassert>
+#include <new>
 
 JobAllocator::~JobAllocator()
 {
-	if (jobAllocator != nullptr) {
-		delete[] jobAllocator;
-		jobAllocator = nullptr;
+	FreeBuffers();
+}
+
+Job* JobAllocator::AllocateBuffer()
+{
+	// Job 是平凡类型，清零后的内存即可直接使用；与 new 一样在内存不足时抛出
+	void* memory = AllocateLocalMemory(sizeof(Job) * size, hugePages);
+	if (!memory) {
+		throw std::bad_alloc();
+	}
+	return static_cast<Job*>(memory);
+}
+
+void JobAllocator::FreeBuffers()
+{
+	for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+		FreeLocalMemory(generations[i], sizeof(Job) * size, hugePages);
+		generations[i] = nullptr;
 	}
+	FreeLocalMemory(rolling, sizeof(Job) * size, hugePages);
+	rolling = nullptr;
+	jobAllocator = nullptr;
 }
 
-void JobAllocator::Initialize(int size)
+void JobAllocator::Initialize(int size, bool hugePages)
 {
 	// 检查 size 是否为 2 的整数次幂
 	assert(size > 0 && (size & (size - 1)) == 0 && "Size must be a power of 2");
 
+	// 重复初始化：参数相同时保留缓冲（线程池复用），否则释放旧缓冲
+	if (size != this->size || hugePages != this->hugePages) {
+		FreeBuffers();
+	}
+
 	this->size = size;
+	this->hugePages = hugePages;
 	index = 0;
-	jobAllocator = new Job[this->size];
+	rollingIndex = 0;
+	generation = 0;
+	frameSlot = 0;
+	jobAllocator = generations[0];
+	jobScratch.Reset();
+	for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+		frameScratch[i].Reset();
+	}
 }
 
-void JobAllocator::FrameStart()
+void JobAllocator::FrameStart(uint32_t frame, uint32_t slot)
 {
+	assert(slot < MAX_FRAMES_IN_FLIGHT && "Slot out of range");
+
+	generation = frame;
+	jobAllocator = generations[slot];
+	index = 0;
+
+	// 该槽位上一次使用的帧已经完成，它的帧级临时内存可以整体回收
+	frameSlot = slot;
+	frameScratch[slot].Reset();
 }
 
 void JobAllocator::FrameEnd()
@@ -28,8 +70,22 @@ void JobAllocator::FrameEnd()
 }
 
 
-Job* JobAllocator::AllocateJob()
+Job* JobAllocator::AllocateJob(bool frameMemory)
 {
+	// 滚动环不随帧重置，与基线一样只在环绕一圈后覆盖
+	if (!frameMemory) {
+		if (rolling == nullptr) {
+			rolling = AllocateBuffer();
+		}
+		rollingIndex++;
+		return &rolling[rollingIndex & (size - 1)];
+	}
+
+	// 槽位缓冲在第一次分配时才创建，不产生 Job 的线程不占内存
+	if (jobAllocator == nullptr) {
+		generations[frameSlot] = AllocateBuffer();
+		jobAllocator = generations[frameSlot];
+	}
 	index++;
 	return &jobAllocator[index & (size - 1)];
 }
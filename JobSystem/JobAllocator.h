@@ -1,18 +1,42 @@
 #pragma once
 #include "Job.h"
+#include "ScratchArena.h"
+#include <cstdint>
 
+// 同时在途的最大帧数（每帧一代 Job 缓冲）
+static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 4;
+
+// 帧栅栏的子孙分配在当前帧的缓冲上，槽位在该帧栅栏完成后才被复用；
+// 其他 Job（没有父 Job、或不在栅栏之下）没有帧可以确认它们完成，分配在不随帧重置的滚动环上
 class JobAllocator {
 private:
 	int index;
+	int rollingIndex;
 	int size;
-	Job* jobAllocator;
+	uint32_t generation;                        // 当前代对应的帧号
+	Job* jobAllocator;                          // 当前代的环形缓冲
+	Job* generations[MAX_FRAMES_IN_FLIGHT];     // 每个槽位一块缓冲，首次使用时分配
+	Job* rolling;                               // 帧栅栏之外的 Job，首次使用时分配
+	ScratchArena jobScratch;                            // Job 级临时内存：ExecuteJob 返回时回退
+	ScratchArena frameScratch[MAX_FRAMES_IN_FLIGHT];    // 帧级临时内存：与 Job 缓冲同槽位轮换
+	uint32_t frameSlot;
+	bool hugePages;
+
+	Job* AllocateBuffer();
+	void FreeBuffers();
 public:
-	JobAllocator() : index(0), size(0), jobAllocator(nullptr) {}
+	JobAllocator() : index(0), rollingIndex(0), size(0), generation(0), jobAllocator(nullptr), generations(), rolling(nullptr), frameSlot(0), hugePages(false) {}
 	~JobAllocator();
 
-	void Initialize(int size = 0);
-	void FrameStart();
+	// 缓冲由调用线程在第一次分配 Job 时分配并首次写入（落在该线程的 NUMA 节点），64 字节对齐
+	// 以相同参数重复初始化时保留已有缓冲，只重置状态
+	void Initialize(int size = 0, bool hugePages = false);
+	// 切换到 frame 帧的缓冲（槽位 slot）；调用方保证该槽位上一次使用的帧已经完成
+	void FrameStart(uint32_t frame, uint32_t slot);
 	void FrameEnd();
-	Job* AllocateJob();
+	uint32_t GetGeneration() const { return generation; }
+	// frameMemory 为 true 时分配在当前帧的缓冲上，否则分配在滚动环上
+	Job* AllocateJob(bool frameMemory);
+	ScratchArena& GetJobScratch() { return jobScratch; }
+	ScratchArena& GetFrameScratch() { return frameScratch[frameSlot]; }
 };
-
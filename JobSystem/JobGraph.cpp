@@ -0,0 +1,249 @@
+#include "JobGraph.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+// 耗时历史表大小（2 的幂），按函数地址线性探测，只登记不删除
+static constexpr uint32_t HISTORY_TABLE_SIZE = 256;
+static constexpr float HISTORY_EMA_WEIGHT = 0.25f;
+// 没有历史的节点按该耗时估计（纳秒）；都没有历史时优先级退化为剩余节点数
+static constexpr uint64_t DEFAULT_NODE_NANOS = 1000;
+
+// ====== 耗时历史 ======
+
+struct JobDurationEntry {
+	std::atomic<JobFunction> key;
+	std::atomic<float> nanos;
+};
+static JobDurationEntry g_durationTable[HISTORY_TABLE_SIZE];
+
+static inline uint32_t HistorySlot(JobFunction func) {
+	uint64_t h = reinterpret_cast<uintptr_t>(func);
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	return static_cast<uint32_t>(h) & (HISTORY_TABLE_SIZE - 1);
+}
+
+void JobDurationHistory::Record(JobFunction func, uint64_t nanos)
+{
+	if (!func) return;
+
+	const uint32_t start = HistorySlot(func);
+	for (uint32_t i = 0; i < HISTORY_TABLE_SIZE; i++) {
+		JobDurationEntry& entry = g_durationTable[(start + i) & (HISTORY_TABLE_SIZE - 1)];
+		JobFunction current = entry.key.load(std::memory_order_acquire);
+		if (current == nullptr) {
+			if (!entry.key.compare_exchange_strong(current, func, std::memory_order_acq_rel) && current != func) {
+				continue;
+			}
+		} else if (current != func) {
+			continue;
+		}
+
+		// 并发更新同一项时丢失个别样本不影响估计
+		const float sample = static_cast<float>(nanos);
+		const float average = entry.nanos.load(std::memory_order_relaxed);
+		entry.nanos.store(average > 0.0f ? average + HISTORY_EMA_WEIGHT * (sample - average) : std::max(sample, 1.0f),
+			std::memory_order_relaxed);
+		return;
+	}
+}
+
+uint64_t JobDurationHistory::Estimate(JobFunction func)
+{
+	if (!func) return 0;
+
+	const uint32_t start = HistorySlot(func);
+	for (uint32_t i = 0; i < HISTORY_TABLE_SIZE; i++) {
+		const JobDurationEntry& entry = g_durationTable[(start + i) & (HISTORY_TABLE_SIZE - 1)];
+		const JobFunction current = entry.key.load(std::memory_order_acquire);
+		if (current == func) return static_cast<uint64_t>(entry.nanos.load(std::memory_order_relaxed));
+		if (current == nullptr) return 0;
+	}
+	return 0;
+}
+
+// ====== 单次执行 ======
+
+struct JobGraphLaunch;
+
+struct JobGraphNodeContext {
+	JobGraphLaunch* launch;
+	JobGraph::NodeId node;
+};
+
+// 一次 Launch 的状态，由最后结束的根 Job / 节点 Job 释放
+// （不另挂清理 continuation：每次 Launch 少创建和调度一个 Job）
+struct JobGraphLaunch {
+	JobSystem* jobSystem;
+	const JobGraph* graph;
+	std::vector<Job*> jobs;
+	std::unique_ptr<std::atomic<int32_t>[]> pending;   // 每个节点尚未满足的前驱数
+	std::vector<JobGraphNodeContext> contexts;
+	std::atomic<uint32_t> remaining;                   // 尚未结束的根 Job + 节点 Job 数
+
+	static void RootJob(Job* job, void* data);
+	static void NodeJob(Job* job, void* data);
+	static void Release(JobGraphLaunch* launch);
+};
+
+void JobGraphLaunch::RootJob(Job*, void* data)
+{
+	// 取消时也要提交：节点是根 Job 的子 Job，必须全部完成计数
+	JobGraphLaunch* launch = static_cast<JobGraphLaunch*>(data);
+	const JobGraph* graph = launch->graph;
+	for (JobGraph::NodeId i = 0; i < graph->nodes.size(); i++) {
+		if (graph->predecessorCount[i] == 0) {
+			launch->jobSystem->RunJob(launch->jobs[i]);
+		}
+	}
+	Release(launch);
+}
+
+void JobGraphLaunch::NodeJob(Job* job, void* data)
+{
+	const JobGraphNodeContext* context = static_cast<const JobGraphNodeContext*>(data);
+	JobGraphLaunch* launch = context->launch;
+	const JobGraph* graph = launch->graph;
+	const JobGraph::Node& node = graph->nodes[context->node];
+
+	// 取消时跳过节点函数，但仍释放后继，否则根 Job 永远等不到它们
+	if (!JobSystem::IsCancelled(job)) {
+		const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+		node.func(job, node.data);
+		const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - begin;
+		JobDurationHistory::Record(node.func,
+			static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+	}
+
+	for (uint32_t i = graph->successorBegin[context->node]; i < graph->successorBegin[context->node + 1]; i++) {
+		const JobGraph::NodeId successor = graph->successors[i];
+		if (launch->pending[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			launch->jobSystem->RunJob(launch->jobs[successor]);
+		}
+	}
+	Release(launch);
+}
+
+void JobGraphLaunch::Release(JobGraphLaunch* launch)
+{
+	if (launch->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		delete launch;
+	}
+}
+
+// ====== JobGraph ======
+
+JobGraph::NodeId JobGraph::AddNode(JobFunction func, void* data)
+{
+	Node node;
+	node.func = func;
+	node.data = data;
+	nodes.push_back(node);
+	compiled = false;
+	return static_cast<NodeId>(nodes.size() - 1);
+}
+
+void JobGraph::AddDependency(NodeId before, NodeId after)
+{
+	dependencies.push_back(std::make_pair(before, after));
+	compiled = false;
+}
+
+bool JobGraph::Compile()
+{
+	const uint32_t count = static_cast<uint32_t>(nodes.size());
+	compiled = false;
+
+	// 后继表（CSR）
+	successorBegin.assign(count + 1, 0);
+	predecessorCount.assign(count, 0);
+	for (const auto& dependency : dependencies) {
+		if (dependency.first >= count || dependency.second >= count || dependency.first == dependency.second) {
+			return false;
+		}
+		successorBegin[dependency.first + 1]++;
+		predecessorCount[dependency.second]++;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		successorBegin[i + 1] += successorBegin[i];
+	}
+	successors.assign(dependencies.size(), 0);
+	std::vector<uint32_t> cursor(successorBegin.begin(), successorBegin.end() - 1);
+	for (const auto& dependency : dependencies) {
+		successors[cursor[dependency.first]++] = dependency.second;
+	}
+
+	// Kahn 拓扑排序，排不完说明有环
+	order.clear();
+	order.reserve(count);
+	std::vector<int32_t> remaining(predecessorCount);
+	for (NodeId i = 0; i < count; i++) {
+		if (remaining[i] == 0) order.push_back(i);
+	}
+	for (size_t k = 0; k < order.size(); k++) {
+		const NodeId node = order[k];
+		for (uint32_t i = successorBegin[node]; i < successorBegin[node + 1]; i++) {
+			if (--remaining[successors[i]] == 0) order.push_back(successors[i]);
+		}
+	}
+	if (order.size() != count) {
+		return false;
+	}
+
+	compiled = true;
+	return true;
+}
+
+Job* JobGraph::Launch(JobSystem& jobSystem, Job* parent)
+{
+	if (!compiled && !Compile()) {
+		return nullptr;
+	}
+
+	// 逆拓扑序求剩余路径长度：节点估计耗时 + 后继中最长的剩余路径
+	// 每次 Launch 单独计算，同时进行的 Launch 互不干扰
+	const uint32_t count = static_cast<uint32_t>(nodes.size());
+	std::vector<uint64_t> bottomLevel(count, 0);
+	uint64_t criticalPath = 0;
+	for (size_t k = order.size(); k-- > 0;) {
+		const NodeId node = order[k];
+		uint64_t longest = 0;
+		for (uint32_t i = successorBegin[node]; i < successorBegin[node + 1]; i++) {
+			longest = std::max(longest, bottomLevel[successors[i]]);
+		}
+		const uint64_t estimate = JobDurationHistory::Estimate(nodes[node].func);
+		bottomLevel[node] = (estimate > 0 ? estimate : DEFAULT_NODE_NANOS) + longest;
+		criticalPath = std::max(criticalPath, bottomLevel[node]);
+	}
+	criticalPathNanos.store(criticalPath, std::memory_order_relaxed);
+
+	JobGraphLaunch* launch = new JobGraphLaunch();
+	launch->jobSystem = &jobSystem;
+	launch->graph = this;
+	launch->jobs.resize(count);
+	launch->pending.reset(new std::atomic<int32_t>[count]);
+	launch->contexts.resize(count);
+	launch->remaining.store(count + 1, std::memory_order_relaxed);
+
+	Job* root = parent ? jobSystem.CreateJob(parent, JobGraphLaunch::RootJob) : jobSystem.CreateJob(JobGraphLaunch::RootJob);
+	root->data = launch;
+	root->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
+	root->priority = static_cast<uint32_t>(std::min<uint64_t>((criticalPath >> 10) + 1, UINT32_MAX));
+
+	// 优先级约为剩余路径的微秒数，至少为 1（0 表示普通 Job）
+	for (NodeId i = 0; i < count; i++) {
+		launch->contexts[i].launch = launch;
+		launch->contexts[i].node = i;
+		launch->pending[i].store(predecessorCount[i], std::memory_order_relaxed);
+
+		Job* job = jobSystem.CreateJob(root, JobGraphLaunch::NodeJob);
+		job->data = &launch->contexts[i];
+		job->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
+		job->priority = static_cast<uint32_t>(std::min<uint64_t>(std::max<uint64_t>(bottomLevel[i] >> 10, 1), UINT32_MAX));
+		launch->jobs[i] = job;
+	}
+	return root;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "Job.h"
+
+class JobSystem;
+
+// ====== 耗时历史 ======
+// 按 Job 函数地址记录执行耗时的指数滑动平均，JobGraph 据此估计节点耗时
+class JobDurationHistory {
+public:
+	static void Record(JobFunction func, uint64_t nanos);
+	// 平均耗时（纳秒），没有记录时返回 0
+	static uint64_t Estimate(JobFunction func);
+};
+
+// ====== 编译后的 Job 图 ======
+// 节点和依赖在启动前一次性声明，Compile 求出拓扑序和后继表；
+// 每次 Launch 按历史耗时计算各节点到图结束的剩余路径长度（bottom level）写入 Job::priority，
+// JobSystemConfig::criticalPathScheduling 开启时，剩余路径越长的就绪节点越先被取走执行
+//
+// 依赖在前驱节点函数返回后满足：节点内派生的子 Job 需要由节点自己等待
+class JobGraph {
+public:
+	typedef uint32_t NodeId;
+
+	JobGraph() : compiled(false), criticalPathNanos(0) {}
+
+	NodeId AddNode(JobFunction func, void* data);
+	// after 在 before 的函数返回后才开始
+	void AddDependency(NodeId before, NodeId after);
+	// 存在环或依赖引用了不存在的节点时返回 false
+	bool Compile();
+	bool IsCompiled() const { return compiled; }
+	size_t GetNodeCount() const { return nodes.size(); }
+
+	// 创建本次执行的所有节点 Job（根 Job 的子 Job），根 Job 运行时提交无前驱的节点
+	// 返回未运行的根 Job，调用方 RunJob + WaitJob；parent 非空时根 Job 作为它的子 Job（如帧栅栏）
+	// 同一个已编译的图可以在多个线程上同时 Launch、同时有多次执行在途（剩余路径长度按次计算）；
+	// 执行期间不能修改图，未编译的图第一次 Launch 时编译，不能与其他 Launch 并发
+	Job* Launch(JobSystem& jobSystem, Job* parent = nullptr);
+
+	// 最近一次 Launch 估计的关键路径长度（纳秒）
+	uint64_t GetCriticalPathEstimate() const { return criticalPathNanos.load(std::memory_order_relaxed); }
+
+private:
+	struct Node {
+		JobFunction func;
+		void* data;
+	};
+
+	std::vector<Node> nodes;
+	std::vector<std::pair<NodeId, NodeId>> dependencies;
+
+	// Compile 的结果
+	bool compiled;
+	std::vector<NodeId> order;                   // 拓扑序
+	std::vector<uint32_t> successorBegin;        // 节点 i 的后继为 successors[successorBegin[i], successorBegin[i + 1])
+	std::vector<NodeId> successors;
+	std::vector<int32_t> predecessorCount;
+	std::atomic<uint64_t> criticalPathNanos;     // 最近一次 Launch 的结果
+
+	friend struct JobGraphLaunch;
+};
@@ -0,0 +1,345 @@
+// Job 图离线分析：读取 JobSystem::BeginGraphCapture 写出的文件，按帧输出
+// 总工作量、关键路径长度、实际耗时、可达加速比、窃取次数和线程空闲间隙，
+// 并列出最慢一帧（--path 时为每帧）的关键路径
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "JobGraphCapture.h"
+
+struct Graph {
+    JobGraphFileHeader header;
+    std::vector<JobGraphRecord> jobs;
+    std::vector<JobGraphEdge> edges;
+    std::vector<std::vector<uint32_t>> children;     // 父 -> 子（记录序号）
+    std::vector<std::vector<uint32_t>> predecessors; // continuation -> 前驱
+};
+
+// 理想调度（无限线程）下的最早开始 / 完成时间
+// 开始：创建者开始后创建它的时刻、所有 continuation 前驱完成；完成：自身执行完且所有子 Job 完成
+struct Schedule {
+    enum Source { NONE, CREATOR, PREDECESSOR };
+
+    const Graph& graph;
+    uint32_t frame;
+    std::vector<uint8_t> startState, finishState;    // 0 未计算 / 1 计算中 / 2 完成
+    std::vector<uint64_t> start, finish;
+    std::vector<uint8_t> startSource;
+    std::vector<uint32_t> startFrom;
+    std::vector<int64_t> finishChild;                // -1 表示由自身执行决定
+
+    Schedule(const Graph& g, uint32_t f)
+        : graph(g), frame(f), startState(g.jobs.size(), 0), finishState(g.jobs.size(), 0),
+          start(g.jobs.size(), 0), finish(g.jobs.size(), 0), startSource(g.jobs.size(), NONE),
+          startFrom(g.jobs.size(), 0), finishChild(g.jobs.size(), -1) {}
+
+    static uint64_t Duration(const JobGraphRecord& job) {
+        return job.endTime > job.startTime && job.startTime != 0 ? job.endTime - job.startTime : 0;
+    }
+
+    // 其他帧的依赖视为帧开始时已满足
+    bool InFrame(uint32_t index) const { return graph.jobs[index].frame == frame; }
+
+    // 完成时间（必要时先计算它依赖的开始 / 完成时间）
+    uint64_t Finish(uint32_t index) {
+        Evaluate(index, true);
+        return FinishValue(index);
+    }
+
+    // continuation 链和父子链可能很长，用显式栈代替递归
+    struct Step {
+        uint32_t index;
+        bool finish;     // 计算完成时间（否则为开始时间）
+        bool expanded;   // 依赖已入栈，再次到达栈顶时计算自身
+    };
+
+    void Evaluate(uint32_t root, bool rootFinish) {
+        std::vector<Step> stack;
+        stack.push_back(Step{ root, rootFinish, false });
+        while (!stack.empty()) {
+            const Step step = stack.back();
+            if (step.expanded) {
+                stack.pop_back();
+                if (step.finish) ComputeFinish(step.index);
+                else ComputeStart(step.index);
+                continue;
+            }
+
+            // 已完成，或是正在计算的祖先（记录不一致形成环时截断，按 0 处理）
+            std::vector<uint8_t>& state = step.finish ? finishState : startState;
+            if (state[step.index] != 0) {
+                stack.pop_back();
+                continue;
+            }
+            state[step.index] = 1;
+            stack.back().expanded = true;
+
+            const JobGraphRecord& job = graph.jobs[step.index];
+            if (step.finish) {
+                stack.push_back(Step{ step.index, false, false });
+                for (uint32_t child : graph.children[step.index]) {
+                    if (InFrame(child)) stack.push_back(Step{ child, true, false });
+                }
+            } else {
+                if (job.creator != 0 && InFrame(job.creator - 1)) {
+                    stack.push_back(Step{ job.creator - 1, false, false });
+                }
+                for (uint32_t predecessor : graph.predecessors[step.index]) {
+                    if (InFrame(predecessor)) stack.push_back(Step{ predecessor, true, false });
+                }
+            }
+        }
+    }
+
+    uint64_t StartValue(uint32_t index) const { return startState[index] == 2 ? start[index] : 0; }
+    uint64_t FinishValue(uint32_t index) const { return finishState[index] == 2 ? finish[index] : 0; }
+
+    // 依赖都已计算（或因成环按 0 处理）
+    void ComputeStart(uint32_t index) {
+        const JobGraphRecord& job = graph.jobs[index];
+        uint64_t value = 0;
+        if (job.creator != 0 && InFrame(job.creator - 1)) {
+            const uint32_t creator = job.creator - 1;
+            const JobGraphRecord& c = graph.jobs[creator];
+            uint64_t offset = job.createTime > c.startTime && c.startTime != 0 ? job.createTime - c.startTime : 0;
+            offset = std::min(offset, Duration(c));
+            value = StartValue(creator) + offset;
+            startSource[index] = CREATOR;
+            startFrom[index] = creator;
+        }
+        for (uint32_t predecessor : graph.predecessors[index]) {
+            if (!InFrame(predecessor)) continue;
+            const uint64_t ready = FinishValue(predecessor);
+            if (ready > value || startSource[index] == NONE) {
+                value = std::max(value, ready);
+                startSource[index] = PREDECESSOR;
+                startFrom[index] = predecessor;
+            }
+        }
+
+        start[index] = value;
+        startState[index] = 2;
+    }
+
+    void ComputeFinish(uint32_t index) {
+        uint64_t value = StartValue(index) + Duration(graph.jobs[index]);
+        for (uint32_t child : graph.children[index]) {
+            if (!InFrame(child)) continue;
+            const uint64_t done = FinishValue(child);
+            if (done > value) {
+                value = done;
+                finishChild[index] = child;
+            }
+        }
+
+        finish[index] = value;
+        finishState[index] = 2;
+    }
+
+    // 从完成最晚的 Job 倒推关键路径上真正执行的 Job，按时间顺序返回
+    std::vector<uint32_t> CriticalPath(uint32_t last) {
+        std::vector<uint32_t> path;
+        uint32_t index = last;
+        bool fromFinish = true;
+        for (size_t guard = 0; guard < graph.jobs.size() * 2; guard++) {
+            if (fromFinish && finishChild[index] >= 0) {
+                index = static_cast<uint32_t>(finishChild[index]);
+                continue;
+            }
+            if (fromFinish) path.push_back(index);
+
+            if (startSource[index] == CREATOR) {
+                // 创建者从开始到创建时刻这一段也在路径上
+                index = startFrom[index];
+                path.push_back(index);
+                fromFinish = false;
+            } else if (startSource[index] == PREDECESSOR) {
+                index = startFrom[index];
+                fromFinish = true;
+            } else {
+                break;
+            }
+        }
+        std::reverse(path.begin(), path.end());
+        path.erase(std::unique(path.begin(), path.end()), path.end());
+        return path;
+    }
+};
+
+struct FrameReport {
+    uint32_t frame;
+    size_t jobs;
+    uint64_t work;
+    uint64_t span;
+    uint64_t wall;
+    size_t steals;
+    uint64_t idle;
+    uint64_t maxGap;
+    std::vector<uint32_t> path;
+};
+
+static bool Load(const char* path, Graph& graph) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+
+    bool ok = fread(&graph.header, sizeof(graph.header), 1, file) == 1 &&
+              memcmp(graph.header.magic, JOB_GRAPH_MAGIC, sizeof(graph.header.magic)) == 0 &&
+              graph.header.version == JOB_GRAPH_VERSION;
+    if (ok) {
+        graph.jobs.resize(graph.header.jobCount);
+        graph.edges.resize(graph.header.edgeCount);
+        ok = (graph.jobs.empty() || fread(graph.jobs.data(), sizeof(JobGraphRecord), graph.jobs.size(), file) == graph.jobs.size()) &&
+             (graph.edges.empty() || fread(graph.edges.data(), sizeof(JobGraphEdge), graph.edges.size(), file) == graph.edges.size());
+    }
+    fclose(file);
+    if (!ok) {
+        fprintf(stderr, "%s is not a valid job graph capture\n", path);
+        return false;
+    }
+
+    const uint32_t count = static_cast<uint32_t>(graph.jobs.size());
+    graph.children.resize(count);
+    graph.predecessors.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t parent = graph.jobs[i].parent;
+        if (parent != 0 && parent <= count) graph.children[parent - 1].push_back(i);
+        if (graph.jobs[i].creator > count) graph.jobs[i].creator = 0;
+    }
+    for (const JobGraphEdge& edge : graph.edges) {
+        if (edge.from == 0 || edge.to == 0 || edge.from > count || edge.to > count) continue;
+        graph.predecessors[edge.to - 1].push_back(edge.from - 1);
+    }
+    return true;
+}
+
+// 各线程在 [begin, end) 内未执行任何 Job 的时间（任意帧的 Job 都算忙，嵌套执行取并集）
+static void MeasureIdle(const Graph& graph, uint64_t begin, uint64_t end, uint64_t* idle, uint64_t* maxGap) {
+    *idle = 0;
+    *maxGap = 0;
+    for (uint32_t thread = 0; thread < graph.header.threadCount; thread++) {
+        std::vector<std::pair<uint64_t, uint64_t>> busy;
+        for (const JobGraphRecord& job : graph.jobs) {
+            if (job.execThread != thread || job.startTime == 0 || job.endTime == 0) continue;
+            if (job.endTime <= begin || job.startTime >= end) continue;
+            busy.push_back(std::make_pair(std::max(job.startTime, begin), std::min(job.endTime, end)));
+        }
+        std::sort(busy.begin(), busy.end());
+
+        uint64_t cursor = begin;
+        for (const auto& interval : busy) {
+            if (interval.first > cursor) {
+                const uint64_t gap = interval.first - cursor;
+                *idle += gap;
+                *maxGap = std::max(*maxGap, gap);
+            }
+            cursor = std::max(cursor, interval.second);
+        }
+        if (end > cursor) {
+            *idle += end - cursor;
+            *maxGap = std::max(*maxGap, end - cursor);
+        }
+    }
+}
+
+static FrameReport Analyze(const Graph& graph, uint32_t frame) {
+    FrameReport report = { frame, 0, 0, 0, 0, 0, 0, 0, std::vector<uint32_t>() };
+    Schedule schedule(graph, frame);
+
+    uint64_t begin = UINT64_MAX, end = 0;
+    int64_t last = -1;
+    for (uint32_t i = 0; i < graph.jobs.size(); i++) {
+        const JobGraphRecord& job = graph.jobs[i];
+        if (job.frame != frame) continue;
+        report.jobs++;
+
+        if (job.startTime != 0 && job.endTime != 0) {
+            report.work += Schedule::Duration(job);
+            begin = std::min(begin, job.startTime);
+            end = std::max(end, job.endTime);
+            if (job.runThread != JOB_GRAPH_NO_THREAD && job.execThread != job.runThread) report.steals++;
+        }
+
+        const uint64_t finish = schedule.Finish(i);
+        if (finish > report.span || last < 0) {
+            report.span = std::max(report.span, finish);
+            last = i;
+        }
+    }
+
+    if (end > begin) {
+        report.wall = end - begin;
+        MeasureIdle(graph, begin, end, &report.idle, &report.maxGap);
+    }
+    if (last >= 0) report.path = schedule.CriticalPath(static_cast<uint32_t>(last));
+    return report;
+}
+
+static double Millis(uint64_t nanos) { return nanos / 1000000.0; }
+
+static void PrintPath(const Graph& graph, const FrameReport& report) {
+    printf("critical path of frame %u: %zu jobs, %.3f ms\n", report.frame, report.path.size(), Millis(report.span));
+    for (uint32_t index : report.path) {
+        const JobGraphRecord& job = graph.jobs[index];
+        printf("  job %-8u func 0x%-16llx thread %-5d %10.3f us\n", index + 1,
+               static_cast<unsigned long long>(job.func),
+               job.execThread == JOB_GRAPH_NO_THREAD ? -1 : static_cast<int>(job.execThread),
+               Schedule::Duration(job) / 1000.0);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <capture file> [--path]\n", argv[0]);
+        return 1;
+    }
+    const bool allPaths = argc > 2 && strcmp(argv[2], "--path") == 0;
+
+    Graph graph;
+    if (!Load(argv[1], graph)) return 1;
+
+    printf("threads %u, frames %u..%u, jobs %u (dropped %u), edges %u (dropped %u)\n",
+           graph.header.threadCount, graph.header.firstFrame,
+           graph.header.firstFrame + graph.header.frameCount - 1,
+           graph.header.jobCount, graph.header.droppedJobs, graph.header.edgeCount, graph.header.droppedEdges);
+    printf("%8s %8s %10s %10s %10s %8s %8s %8s %10s %10s\n",
+           "frame", "jobs", "work(ms)", "span(ms)", "wall(ms)", "par", "maxpar", "steals", "idle(ms)", "gap(ms)");
+
+    // 帧号取记录中实际出现的范围（不限帧数的捕获没有上界）
+    uint32_t firstFrame = UINT32_MAX, lastFrame = 0;
+    for (const JobGraphRecord& job : graph.jobs) {
+        firstFrame = std::min(firstFrame, job.frame);
+        lastFrame = std::max(lastFrame, job.frame);
+    }
+
+    std::vector<FrameReport> reports;
+    for (uint32_t frame = firstFrame; !graph.jobs.empty() && frame <= lastFrame; frame++) {
+        FrameReport report = Analyze(graph, frame);
+        if (report.jobs == 0) continue;
+
+        // par：实际并行度（工作量 / 实际耗时）；maxpar：可达加速比上限（工作量 / 关键路径）
+        printf("%8u %8zu %10.3f %10.3f %10.3f %8.2f %8.2f %8zu %10.3f %10.3f\n",
+               frame, report.jobs, Millis(report.work), Millis(report.span), Millis(report.wall),
+               report.wall ? static_cast<double>(report.work) / report.wall : 0.0,
+               report.span ? static_cast<double>(report.work) / report.span : 0.0,
+               report.steals, Millis(report.idle), Millis(report.maxGap));
+        reports.push_back(report);
+        if (frame == UINT32_MAX) break;
+    }
+    if (reports.empty()) return 0;
+
+    // 最慢一帧：实际耗时接近关键路径说明是串行链过长，远大于关键路径说明是调度问题
+    size_t slowest = 0;
+    for (size_t i = 1; i < reports.size(); i++) {
+        if (reports[i].wall > reports[slowest].wall) slowest = i;
+    }
+    printf("\n");
+    if (allPaths) {
+        for (const FrameReport& report : reports) PrintPath(graph, report);
+    } else {
+        PrintPath(graph, reports[slowest]);
+    }
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include "JobGraphCapture.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+thread_local uint32_t JobGraphCapture::currentJob = 0;
+
+static constexpr uint32_t CAPTURE_INDEX_MASK = (1u << 24) - 1;
+
+// 记录中的编号去掉代号，变为文件中的"序号 + 1"
+static uint32_t StripGeneration(uint32_t id) {
+	return id & CAPTURE_INDEX_MASK;
+}
+
+// 记录调用期间计数：先计数再检查代号（均为 seq_cst），与 Finish 先作废代号再检查计数配对，
+// 两边至少有一方看到对方——要么记录调用看到代号已作废，要么 Finish 等它写完
+struct JobGraphCapture::WriterScope {
+	std::atomic<uint32_t>& writers;
+
+	explicit WriterScope(std::atomic<uint32_t>& writers) : writers(writers) { writers.fetch_add(1); }
+	~WriterScope() { writers.fetch_sub(1, std::memory_order_release); }
+};
+
+uint64_t JobGraphCapture::Now() const
+{
+	const uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+	// 0 保留给"未发生"
+	return now - origin + 1;
+}
+
+void JobGraphCapture::Start(const char* path, int threadCount, uint32_t firstFrame, uint32_t lastFrame, uint32_t maxJobs)
+{
+	if (maxJobs == 0 || maxJobs > MAX_JOBS) maxJobs = MAX_JOBS;
+
+	// 按页补齐缓冲，已有的页保留原地址
+	jobCapacity = maxJobs;
+	edgeCapacity = maxJobs;
+	const uint32_t pages = (maxJobs + PAGE_SIZE - 1) >> PAGE_SHIFT;
+	for (uint32_t i = 0; i < pages; i++) {
+		if (!recordPages[i]) recordPages[i].reset(new JobGraphRecord[PAGE_SIZE]);
+		if (!edgePages[i]) edgePages[i].reset(new JobGraphEdge[PAGE_SIZE]);
+		memset(recordPages[i].get(), 0, sizeof(JobGraphRecord) * PAGE_SIZE);
+	}
+
+	this->path = path ? path : "JobGraph.bin";
+	this->threadCount = threadCount;
+	this->firstFrame = firstFrame;
+	this->lastFrame = lastFrame;
+	lastGeneration = lastGeneration % 255 + 1;
+	nextJob.store(0, std::memory_order_relaxed);
+	nextEdge.store(0, std::memory_order_relaxed);
+	origin = 0;
+	origin = Now() - 1;
+	generation.store(lastGeneration);
+	recording.store(true, std::memory_order_release);
+}
+
+JobGraphRecord* JobGraphCapture::Find(uint32_t id)
+{
+	const uint32_t current = generation.load();
+	if (current == 0 || (id >> 24) != current) return nullptr;
+	const uint32_t index = StripGeneration(id) - 1;
+	return index < jobCapacity ? &Record(index) : nullptr;
+}
+
+uint32_t JobGraphCapture::RecordCreate(uint32_t parentId, JobFunction func, uint32_t currentFrame)
+{
+	WriterScope scope(activeWriters);
+	const uint32_t current = generation.load();
+	if (current == 0) return 0;
+
+	// 父 Job 或创建者属于捕获时沿用它的帧，否则只记录捕获帧范围内的根 Job
+	const JobGraphRecord* parent = Find(parentId);
+	const uint32_t creatorId = currentJob;
+	const JobGraphRecord* creator = Find(creatorId);
+	uint32_t frame = currentFrame;
+	if (parent) frame = parent->frame;
+	else if (creator) frame = creator->frame;
+	else if (currentFrame < firstFrame || currentFrame > lastFrame) return 0;
+
+	const uint32_t index = nextJob.fetch_add(1, std::memory_order_relaxed);
+	if (index >= jobCapacity) return 0;
+
+	JobGraphRecord& record = Record(index);
+	record.func = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(func));
+	record.createTime = Now();
+	record.parent = parent ? StripGeneration(parentId) : 0;
+	record.creator = creator ? StripGeneration(creatorId) : 0;
+	record.frame = frame;
+	record.runThread = JOB_GRAPH_NO_THREAD;
+	record.execThread = JOB_GRAPH_NO_THREAD;
+	return (current << 24) | (index + 1);
+}
+
+void JobGraphCapture::RecordRun(uint32_t id, int threadIndex)
+{
+	WriterScope scope(activeWriters);
+	JobGraphRecord* record = Find(id);
+	if (!record) return;
+	record->readyTime = Now();
+	record->runThread = threadIndex >= 0 ? static_cast<uint16_t>(threadIndex) : JOB_GRAPH_NO_THREAD;
+}
+
+void JobGraphCapture::RecordStart(uint32_t id, int threadIndex)
+{
+	WriterScope scope(activeWriters);
+	JobGraphRecord* record = Find(id);
+	if (!record) return;
+	record->startTime = Now();
+	record->execThread = threadIndex >= 0 ? static_cast<uint16_t>(threadIndex) : JOB_GRAPH_NO_THREAD;
+}
+
+void JobGraphCapture::RecordEnd(uint32_t id)
+{
+	WriterScope scope(activeWriters);
+	JobGraphRecord* record = Find(id);
+	if (!record) return;
+	record->endTime = Now();
+}
+
+void JobGraphCapture::RecordEdge(uint32_t from, uint32_t to)
+{
+	WriterScope scope(activeWriters);
+	if (!Find(from) || !Find(to)) return;
+
+	const uint32_t index = nextEdge.fetch_add(1, std::memory_order_relaxed);
+	if (index >= edgeCapacity) return;
+	JobGraphEdge& edge = Edge(index);
+	edge.from = StripGeneration(from);
+	edge.to = StripGeneration(to);
+}
+
+bool JobGraphCapture::Finish()
+{
+	if (!recording.exchange(false, std::memory_order_acq_rel)) return false;
+
+	// 作废代号：之后的记录调用都找不到记录；已经通过检查的调用写完后才读取缓冲
+	generation.store(0);
+	while (activeWriters.load() != 0) {
+		std::this_thread::yield();
+	}
+
+	const uint32_t jobsTotal = nextJob.load(std::memory_order_acquire);
+	const uint32_t edgesTotal = nextEdge.load(std::memory_order_acquire);
+
+	JobGraphFileHeader header;
+	memcpy(header.magic, JOB_GRAPH_MAGIC, sizeof(header.magic));
+	header.version = JOB_GRAPH_VERSION;
+	header.threadCount = static_cast<uint32_t>(threadCount);
+	header.jobCount = jobsTotal < jobCapacity ? jobsTotal : jobCapacity;
+	// 写实际记录到的帧范围：不限帧数的捕获 lastFrame 为 UINT32_MAX，提前结束的捕获也不到 lastFrame
+	uint32_t maxFrame = firstFrame;
+	for (uint32_t i = 0; i < header.jobCount; i++) {
+		if (Record(i).frame > maxFrame) maxFrame = Record(i).frame;
+	}
+	header.firstFrame = firstFrame;
+	header.frameCount = header.jobCount > 0 ? maxFrame - firstFrame + 1 : 0;
+	header.edgeCount = edgesTotal < edgeCapacity ? edgesTotal : edgeCapacity;
+	header.droppedJobs = jobsTotal - header.jobCount;
+	header.droppedEdges = edgesTotal - header.edgeCount;
+	header.reserved = 0;
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file) return false;
+
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+	for (uint32_t i = 0; ok && i < header.jobCount; i += PAGE_SIZE) {
+		const uint32_t n = header.jobCount - i < PAGE_SIZE ? header.jobCount - i : PAGE_SIZE;
+		ok = fwrite(recordPages[i >> PAGE_SHIFT].get(), sizeof(JobGraphRecord), n, file) == n;
+	}
+	for (uint32_t i = 0; ok && i < header.edgeCount; i += PAGE_SIZE) {
+		const uint32_t n = header.edgeCount - i < PAGE_SIZE ? header.edgeCount - i : PAGE_SIZE;
+		ok = fwrite(edgePages[i >> PAGE_SHIFT].get(), sizeof(JobGraphEdge), n, file) == n;
+	}
+	return fclose(file) == 0 && ok;
+}
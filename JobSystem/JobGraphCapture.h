@@ -0,0 +1,107 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "Job.h"
+
+// ====== 文件格式 ======
+// JobGraphFileHeader，随后 jobCount 个 JobGraphRecord，再随后 edgeCount 个 JobGraphEdge
+// Job 编号为记录序号 + 1（0 表示无），时间为相对捕获开始的纳秒
+
+static constexpr char JOB_GRAPH_MAGIC[4] = { 'J', 'S', 'G', 'C' };
+static constexpr uint32_t JOB_GRAPH_VERSION = 1;
+static constexpr uint16_t JOB_GRAPH_NO_THREAD = 0xFFFF;
+
+struct JobGraphFileHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t threadCount;
+	uint32_t firstFrame;
+	uint32_t frameCount;
+	uint32_t jobCount;
+	uint32_t edgeCount;
+	uint32_t droppedJobs;       // 缓冲已满未能记录的 Job 数
+	uint32_t droppedEdges;
+	uint32_t reserved;
+};
+
+struct JobGraphRecord {
+	uint64_t func;              // Job 函数地址，用于归类
+	uint64_t createTime;
+	uint64_t readyTime;         // RunJob（或 continuation 被触发）的时间，0 表示未提交
+	uint64_t startTime;
+	uint64_t endTime;           // 函数返回的时间，0 表示捕获结束时尚未执行
+	uint32_t parent;            // 父 Job
+	uint32_t creator;           // 创建它时本线程正在执行的 Job
+	uint32_t frame;
+	uint16_t runThread;         // 提交到哪个线程的队列
+	uint16_t execThread;        // 实际执行的线程，与 runThread 不同即为被窃取
+};
+
+// continuation 依赖：to 在 from（连同其子 Job）完成后才开始
+struct JobGraphEdge {
+	uint32_t from;
+	uint32_t to;
+};
+
+// ====== 捕获 ======
+// Job 的 captureId 高 8 位为捕获代号，低 24 位为编号，旧捕获遗留的 Job 不会写入新捕获
+// 记录缓冲按页在 Start 时分配，记录过程只做原子自增和普通写入
+// 页只增不减、不移动：旧捕获遗留的记录调用可能在代号检查之后仍持有旧地址
+// Finish 先作废代号，再等正在进行的记录调用结束，写文件期间缓冲不再被修改
+class JobGraphCapture {
+public:
+	static constexpr uint32_t MAX_JOBS = (1u << 24) - 1;
+	static constexpr uint32_t PAGE_SHIFT = 16;
+	static constexpr uint32_t PAGE_SIZE = 1u << PAGE_SHIFT;
+	static constexpr uint32_t PAGE_COUNT = (MAX_JOBS >> PAGE_SHIFT) + 1;
+
+	JobGraphCapture() : recording(false), generation(0), lastGeneration(0), activeWriters(0), threadCount(0), firstFrame(0),
+		lastFrame(0), origin(0), jobCapacity(0), edgeCapacity(0), nextJob(0), nextEdge(0) {}
+
+	// 开始记录 [firstFrame, lastFrame] 帧创建的 Job 以及它们派生的 Job
+	void Start(const char* path, int threadCount, uint32_t firstFrame, uint32_t lastFrame, uint32_t maxJobs);
+	// 停止记录并写出文件，失败返回 false
+	bool Finish();
+	bool IsRecording() const { return recording.load(std::memory_order_relaxed); }
+	uint32_t GetLastFrame() const { return lastFrame; }
+
+	// 返回新 Job 的 captureId；不属于捕获范围或缓冲已满时返回 0
+	uint32_t RecordCreate(uint32_t parentId, JobFunction func, uint32_t currentFrame);
+	void RecordRun(uint32_t id, int threadIndex);
+	void RecordStart(uint32_t id, int threadIndex);
+	void RecordEnd(uint32_t id);
+	void RecordEdge(uint32_t from, uint32_t to);
+
+	// 本线程正在执行的 Job（嵌套执行时由调用方保存和恢复）
+	static uint32_t GetCurrentJob() { return currentJob; }
+	static void SetCurrentJob(uint32_t id) { currentJob = id; }
+
+private:
+	struct WriterScope;
+
+	// 属于当前捕获时返回记录，否则返回 nullptr（调用方持有 WriterScope）
+	JobGraphRecord* Find(uint32_t id);
+	JobGraphRecord& Record(uint32_t index) { return recordPages[index >> PAGE_SHIFT][index & (PAGE_SIZE - 1)]; }
+	JobGraphEdge& Edge(uint32_t index) { return edgePages[index >> PAGE_SHIFT][index & (PAGE_SIZE - 1)]; }
+	uint64_t Now() const;
+
+	static thread_local uint32_t currentJob;
+
+	std::atomic<bool> recording;
+	std::atomic<uint32_t> generation;            // 正在记录的捕获代号，0 表示没有
+	uint32_t lastGeneration;                     // 上一次 Start 使用的代号
+	std::atomic<uint32_t> activeWriters;         // 正在进行的记录调用数
+	std::string path;
+	int threadCount;
+	uint32_t firstFrame;
+	uint32_t lastFrame;
+	uint64_t origin;
+	std::unique_ptr<JobGraphRecord[]> recordPages[PAGE_COUNT];
+	std::unique_ptr<JobGraphEdge[]> edgePages[PAGE_COUNT];
+	uint32_t jobCapacity;
+	uint32_t edgeCapacity;
+	std::atomic<uint32_t> nextJob;
+	std::atomic<uint32_t> nextEdge;
+};
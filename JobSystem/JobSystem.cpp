@@ -1,73 +1,558 @@
 #include "JobSystem.h"
+#include "JobGraph.h"
+#include <algorithm>
+#include <chrono>
+#include <new>
+
+// 本地队列长度达到该值时唤醒一个停驻的工作线程
+static constexpr size_t WAKE_QUEUE_DEPTH = 2;
+// Job 图捕获默认记录上限
+static constexpr uint32_t DEFAULT_CAPTURE_MAX_JOBS = 1u << 20;
+// 每个线程每执行这么多个 Job 计时一个，按函数记入耗时历史（JOB_WAIT_HELP_BUDGET 据此估计）
+static constexpr uint32_t DURATION_SAMPLE_INTERVAL = 16;
 thread_local int* tlthreadIndex = nullptr;
 thread_local JobAllocator g_jobAllocator;
+thread_local Job* tlcurrentJob = nullptr;
+// 当前线程正在执行 Job 时指向它的心跳（AnnotateCurrentJob 用）
+thread_local ThreadHeartbeat* tlheartbeat = nullptr;
+thread_local uint32_t tldurationSample = 0;
 std::vector<WorkThreadStealQueue*> g_threadsJobQueue;
 
+// 进程级工作线程池：线程 threads[i] 的线程索引为 i + 1
+// 实例 Initialize 时接管（attach）前 numThreads - 1 个线程，ShutDown 时交还；
+// 非 persistentWorkers 实例在 ShutDown 时结束所有线程
+struct WorkerPool {
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::vector<std::thread> threads;
+	JobSystem* system;         // 当前接管线程池的实例
+	int attachCount;           // 接管的线程数
+	int attachedWorkers;       // 仍在为 system 工作的线程数
+	uint64_t generation;       // 每次接管加一，线程据此区分新旧实例
+	bool exiting;
+
+	WorkerPool() : system(nullptr), attachCount(0), attachedWorkers(0), generation(0), exiting(false) {}
+	~WorkerPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			exiting = true;
+		}
+		condition.notify_all();
+		for (auto& thread : threads) {
+			// 进程退出时仍有实例未销毁：线程还在执行 Job 循环，无法等待
+			if (system) thread.detach();
+			else if (thread.joinable()) thread.join();
+		}
+	}
+};
+static WorkerPool g_workerPool;
+
 
 #pragma region JobSystem生命周期
+JobSystemConfig JobSystem::DefaultConfig() {
+	JobSystemConfig config;
+	config.numThreads = 0;
+	config.pinThreads = 0;
+	config.pinCoreClasses = 0;
+	config.hugePages = 0;
+	config.minWorkers = 1;
+	config.parkIdleMicros = 2000;
+	config.persistentWorkers = 0;
+	config.deferLogOpen = 0;
+	config.shutdownMode = JOBSYSTEM_SHUTDOWN_DRAIN;
+	config.criticalPathScheduling = 0;
+	config.mainThreadWaitPolicy = JOB_WAIT_HELP_SUBTREE;
+	config.backgroundWorkers = 1;
+	config.backgroundBudgetMicros = 0;
+	config.backgroundSliceMicros = 1000;
+	config.healthIntervalMicros = 100000;
+	config.healthLongJobMicros = 100000;
+	config.healthWaitTimeoutMicros = 2000000;
+	config.healthStallMicros = 2000000;
+	config.healthQueueGrowthSamples = 20;
+	return config;
+}
+
 void JobSystem::Initialize() {
-	numThreads = std::thread::hardware_concurrency();
-	g_threadsJobQueue.resize(numThreads);
+	Initialize(DefaultConfig());
+}
 
-	// 打开日志文件
-	frameCounter = 0;
-	logFile.open("JobSystemDebug.txt", std::ios::out | std::ios::trunc);
-	if (logFile.is_open()) {
-		logFile << "=== JobSystem Debug Log ===\n";
-		logFile << "Initialized with " << numThreads << " threads\n";
-		logFile << "============================\n\n";
-		logFile.flush();
+void JobSystem::Initialize(const JobSystemConfig& cfg) {
+	config = cfg;
+	numThreads = config.numThreads > 0 ? static_cast<int>(config.numThreads) : static_cast<int>(std::thread::hardware_concurrency());
+	if (numThreads < 1) numThreads = 1;
+	// 线程池保留的队列继续使用（只增不减，多出的队列属于本实例未接管的线程）
+	if (static_cast<int>(g_threadsJobQueue.size()) < numThreads) {
+		g_threadsJobQueue.resize(numThreads, nullptr);
 	}
 
-	// First, create all queues before starting threads
-	for (int i = 0; i < numThreads; i++)
-	{
-		g_threadsJobQueue[i] = new WorkThreadStealQueue();
+	// 读取 CPU 拓扑，按主线程当前所在 CPU 为各线程分配 CPU 并计算窃取顺序
+	topology.Load();
+	threadCpus = topology.AssignThreads(numThreads, CpuTopology::CurrentCpu());
+	BuildStealOrders();
+
+	// 大小核分类：主线程承担帧的关键路径，始终按大核处理
+	heterogeneous = topology.IsHeterogeneous();
+	threadIsBig.assign(numThreads, 1);
+	for (int i = 1; i < numThreads; i++) {
+		threadIsBig[i] = topology.IsBigCore(threadCpus[i]) ? 1 : 0;
 	}
 
-	// Initialize main thread
+	// 打开日志文件（deferLogOpen 时推迟到第一次 Log）
+	frameCounter = 0;
+	logOpened = false;
+	if (!config.deferLogOpen) {
+		std::lock_guard<std::mutex> lock(logMutex);
+		OpenLog();
+	}
+
+	// Initialize main thread：队列和 Job 缓冲在再次创建时复用
 	tlthreadIndex = new int(0);
-	g_jobAllocator.Initialize(MAX_NUMBER_OF_JOBS_PERTTHREAD);
+	if (!g_threadsJobQueue[0]) {
+		g_threadsJobQueue[0] = CreateLocalQueue();
+	}
+	g_jobAllocator.Initialize(MAX_NUMBER_OF_JOBS_PERTTHREAD, config.hugePages != 0);
+
+	// 帧流水线：默认只允许一帧在途（FrameStart 等待上一帧完成）
+	frameState = 0;
+	currentFrame = 0;
+	currentSlot = 0;
+	pipelineDepth = 1;
+	drainedFrame = 0;
+	frameOpen = false;
+	for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+		frameFences[i] = nullptr;
+	}
+	captureArmed = false;
 
 	isRunning = true;
+	discardPending = false;
+	readyWorkers = 0;
 
-	// Now start worker threads
-	for (int i = 0; i < numThreads - 1; i++)
-	{
-		workerThreads.emplace_back([this, i]() {
-			WorkerThreadFunction(i + 1);
+	criticalPathScheduling = config.criticalPathScheduling != 0;
+	mainThreadWaitPolicy = static_cast<uint32_t>(config.mainThreadWaitPolicy);
+	blockedWaiters = 0;
+	backgroundLane.Configure(config.backgroundWorkers, config.backgroundBudgetMicros, config.backgroundSliceMicros);
+
+	// 弹性线程数：所有工作线程启动时都是活跃的，空闲超时后逐个停驻到 minWorkers
+	minWorkers = std::min(static_cast<int>(std::min(config.minWorkers, 0x7FFFFFFFu)), numThreads - 1);
+	activeWorkers = numThreads - 1;
+	parkedWorkers = 0;
+	wakeRequests = 0;
+	parkCount = 0;
+	wakeCount = 0;
+	lastWakeQueueDepth = 0;
+	counters = std::vector<ThreadSchedulerCounters>(numThreads);
+	foreignCounters.jobsQueued = 0;
+	foreignCounters.jobsExecuted = 0;
+	heartbeats = std::vector<ThreadHeartbeat>(numThreads);
+	healthMonitor.Configure(config, heartbeats.data(), numThreads, ReadHealthCounters, this);
+
+	// Now start worker threads：接管线程池（不足时补充线程），每个工作线程在自己的 CPU 上
+	// 分配队列和 Job 缓冲（first-touch）
+	AttachWorkers();
+
+	// 等所有队列就绪后再返回，之后 g_threadsJobQueue 只读
+	while (readyWorkers.load(std::memory_order_acquire) < numThreads - 1) {
+		Yield();
+	}
+}
+
+void JobSystem::AttachWorkers() {
+	std::lock_guard<std::mutex> lock(g_workerPool.mutex);
+	while (static_cast<int>(g_workerPool.threads.size()) < numThreads - 1) {
+		const int threadIndex = static_cast<int>(g_workerPool.threads.size()) + 1;
+		g_workerPool.threads.emplace_back(PoolThreadFunction, threadIndex);
+	}
+
+	g_workerPool.system = this;
+	g_workerPool.attachCount = numThreads - 1;
+	g_workerPool.attachedWorkers = numThreads - 1;
+	g_workerPool.generation++;
+	g_workerPool.condition.notify_all();
+}
+
+void JobSystem::DetachWorkers() {
+	std::unique_lock<std::mutex> lock(g_workerPool.mutex);
+	g_workerPool.condition.wait(lock, []() { return g_workerPool.attachedWorkers == 0; });
+	g_workerPool.system = nullptr;
+	g_workerPool.attachCount = 0;
+	if (config.persistentWorkers) {
+		return;
+	}
+
+	// 非常驻：结束所有线程（包括以前的常驻实例留下的）
+	g_workerPool.exiting = true;
+	g_workerPool.condition.notify_all();
+	std::vector<std::thread> threads;
+	threads.swap(g_workerPool.threads);
+	lock.unlock();
+
+	for (auto& thread : threads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+
+	lock.lock();
+	g_workerPool.exiting = false;
+}
+
+bool JobSystem::ReleaseWorkerPool() {
+	std::unique_lock<std::mutex> lock(g_workerPool.mutex);
+	if (g_workerPool.system) {
+		return false;
+	}
+
+	g_workerPool.exiting = true;
+	g_workerPool.condition.notify_all();
+	std::vector<std::thread> threads;
+	threads.swap(g_workerPool.threads);
+	lock.unlock();
+
+	for (auto& thread : threads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+
+	lock.lock();
+	g_workerPool.exiting = false;
+
+	// 线程已结束，它们的队列不再被访问
+	for (size_t i = 1; i < g_threadsJobQueue.size(); i++) {
+		DestroyLocalQueue(g_threadsJobQueue[i]);
+		g_threadsJobQueue[i] = nullptr;
+	}
+	return true;
+}
+
+void JobSystem::PoolThreadFunction(int threadIndex) {
+	uint64_t servedGeneration = 0;
+	std::unique_lock<std::mutex> lock(g_workerPool.mutex);
+	for (;;) {
+		// 等待新实例接管本线程（线程索引超出实例线程数时继续空闲）
+		g_workerPool.condition.wait(lock, [&]() {
+			return g_workerPool.exiting ||
+				(g_workerPool.system && g_workerPool.generation != servedGeneration && threadIndex <= g_workerPool.attachCount);
 		});
+		if (g_workerPool.exiting) {
+			break;
+		}
+
+		servedGeneration = g_workerPool.generation;
+		JobSystem* system = g_workerPool.system;
+		lock.unlock();
+
+		system->WorkerThreadFunction(threadIndex);
+
+		lock.lock();
+		if (--g_workerPool.attachedWorkers == 0) {
+			g_workerPool.condition.notify_all();
+		}
+	}
+}
+
+void JobSystem::BuildStealOrders() {
+	stealOrders.assign(numThreads, StealOrder());
+	for (int i = 0; i < numThreads; i++) {
+		for (int j = 0; j < numThreads; j++) {
+			if (i == j) continue;
+			const int distance = topology.Distance(threadCpus[i], threadCpus[j]);
+			stealOrders[i].victims[distance].push_back(j);
+		}
 	}
 }
 
+WorkThreadStealQueue* JobSystem::CreateLocalQueue() {
+	void* memory = AllocateLocalMemory(sizeof(WorkThreadStealQueue), false);
+	if (!memory) {
+		throw std::bad_alloc();
+	}
+	return new (memory) WorkThreadStealQueue();
+}
+
+void JobSystem::DestroyLocalQueue(WorkThreadStealQueue* queue) {
+	if (!queue) return;
+	queue->~WorkThreadStealQueue();
+	FreeLocalMemory(queue, sizeof(WorkThreadStealQueue), false);
+}
+
+// 等待期间标记心跳，所有返回路径上结束
+struct WaitHeartbeatScope {
+	ThreadHeartbeat* heartbeat;
+
+	WaitHeartbeatScope(ThreadHeartbeat* heartbeat, JobFunction func) : heartbeat(heartbeat) {
+		if (heartbeat) heartbeat->BeginWait(func);
+	}
+	~WaitHeartbeatScope() {
+		if (heartbeat) heartbeat->EndWait();
+	}
+};
+
+static void FrameFenceJobFunction(Job*, void*) {
+	// 栅栏本身不做事，只用于等待本帧挂在它下面的 Job
+}
+
 void JobSystem::FrameStart()
 {
+	if (frameOpen) {
+		FrameEnd();
+	}
+
+	const uint32_t frame = currentFrame + 1;
+
+	// 流水线已满：等待最早的在途帧完成，它使用的 Job 缓冲槽位才能被回收
+	if (frame > pipelineDepth) {
+		const uint32_t oldest = frame - pipelineDepth;
+		if (oldest > drainedFrame) {
+			WaitJob(frameFences[oldest % MAX_FRAMES_IN_FLIGHT]);
+		}
+	}
+
+	// 切换到新一代 Job 缓冲：所有线程在下一次 CreateJob 时跟随切换
+	currentSlot = (currentSlot + 1) % (pipelineDepth + 1);
+	currentFrame = frame;
+	frameState.store((static_cast<uint64_t>(frame) << 32) | currentSlot, std::memory_order_release);
+
+	// Job 图捕获：从本帧开始记录；最后一帧已确认完成（流水线等待之后）则写出
+	if (captureArmed) {
+		captureArmed = false;
+		graphCapture.Start(capturePath.c_str(), numThreads, frame, frame + captureFrames - 1, captureMaxJobs);
+	} else if (graphCapture.IsRecording() && frame > graphCapture.GetLastFrame() &&
+		graphCapture.GetLastFrame() + pipelineDepth <= frame) {
+		graphCapture.Finish();
+	}
+
+	frameFences[frame % MAX_FRAMES_IN_FLIGHT] = CreateRootJob(FrameFenceJobFunction, true);
+	frameOpen = true;
+
+	// 主线程在 Job 之外申请的 Job 级临时内存到此回收
+	g_jobAllocator.GetJobScratch().Reset();
+
+	// 后台通道的每帧预算重新开始；预算用完后停驻的线程需要唤醒
+	backgroundLane.FrameStart();
+	if (backgroundLane.HasWork()) {
+		WakeWorker(0);
+	}
 }
 
 void JobSystem::FrameEnd()
 {
+	// 帧尾执行已就绪的主线程 Job
+	PumpMainThread();
+
+	// 没有工作线程：后台任务每帧在这里执行一个时间片
+	// 本帧的 Job 只能由主线程执行，排队的 Job 不算抢占，时间片只受长度和预算限制
+	if (numThreads == 1) {
+		backgroundLane.RunSlice(nullptr, nullptr);
+	}
+
+	if (!frameOpen) {
+		return;
+	}
+	frameOpen = false;
+
+	// 不等待：栅栏在本帧所有子 Job 完成后完成，下一帧可以立即开始
+	RunJob(frameFences[currentFrame % MAX_FRAMES_IN_FLIGHT]);
+}
+
+void JobSystem::DrainFrames()
+{
+	const uint32_t lastClosed = frameOpen ? currentFrame - 1 : currentFrame;
+	const uint32_t first = lastClosed >= pipelineDepth ? lastClosed - pipelineDepth + 1 : 1;
+
+	for (uint32_t frame = std::max(first, drainedFrame + 1); frame <= lastClosed; frame++) {
+		WaitJob(frameFences[frame % MAX_FRAMES_IN_FLIGHT]);
+	}
+	if (lastClosed > drainedFrame) {
+		drainedFrame = lastClosed;
+	}
+}
+
+void JobSystem::SetPipelineDepth(uint32_t depth)
+{
+	if (depth < 1) depth = 1;
+	if (depth > MAX_FRAMES_IN_FLIGHT - 1) depth = MAX_FRAMES_IN_FLIGHT - 1;
+	if (depth == pipelineDepth) return;
+
+	// 槽位数量改变前确保旧的在途帧都已完成
+	DrainFrames();
+	pipelineDepth = depth;
+}
+
+Job* JobSystem::GetFrameFence()
+{
+	return frameOpen ? frameFences[currentFrame % MAX_FRAMES_IN_FLIGHT] : nullptr;
+}
+
+bool JobSystem::BeginGraphCapture(const char* path, uint32_t frameCount, uint32_t maxJobs)
+{
+	if (captureArmed || graphCapture.IsRecording()) {
+		return false;
+	}
+
+	capturePath = path ? path : "JobGraph.bin";
+	captureMaxJobs = maxJobs > 0 ? maxJobs : DEFAULT_CAPTURE_MAX_JOBS;
+	if (frameCount == 0) {
+		// 不限帧数：当前帧及之后的 Job 全部记录
+		graphCapture.Start(capturePath.c_str(), numThreads, currentFrame, UINT32_MAX, captureMaxJobs);
+		return true;
+	}
+
+	captureFrames = frameCount;
+	captureArmed = true;
+	return true;
+}
+
+bool JobSystem::EndGraphCapture()
+{
+	if (captureArmed) {
+		captureArmed = false;
+		return false;
+	}
+	if (!graphCapture.IsRecording()) {
+		return false;
+	}
+
+	// 已结束的在途帧都完成后再写出，正在进行的帧只包含已完成的部分
+	DrainFrames();
+	return graphCapture.Finish();
+}
+
+Job* JobSystem::GetPreviousFrameFence()
+{
+	const uint32_t previous = frameOpen ? currentFrame - 1 : currentFrame;
+	return previous > 0 ? frameFences[previous % MAX_FRAMES_IN_FLIGHT] : nullptr;
 }
 
 void JobSystem::ShutDown()
 {
-	isRunning = false;
+	// 丢弃模式：从现在起未执行的 Job 都按取消处理，下面的等待很快结束
+	discardPending = config.shutdownMode == JOBSYSTEM_SHUTDOWN_DISCARD;
 
-	for (auto& thread : workerThreads) {
-		if (thread.joinable()) {
-			thread.join();
+	// 关闭前等待所有在途帧完成
+	FrameEnd();
+	DrainFrames();
+	EndGraphCapture();
+
+	// 后台任务：丢弃模式取消，否则不限预算执行完（正在其他线程上执行的时间片结束后回到队列）
+	if (discardPending) {
+		backgroundLane.CancelAll();
+	}
+	while (backgroundLane.HasWork() || backgroundLane.IsRunning()) {
+		if (discardPending) {
+			backgroundLane.CancelAll();
+		}
+		if (!backgroundLane.RunSlice(nullptr, nullptr, true)) {
+			Yield();
 		}
 	}
-	workerThreads.clear();
 
-	for (auto* queue : g_threadsJobQueue) {
-		if (queue != nullptr) {
-			delete queue;
+	// 再排空帧之外提交的 Job：所有 RunJob 过的 Job 都执行（或取消）完才停止工作线程，
+	// 常驻线程交还线程池时队列为空
+	while (HasPendingJobs()) {
+		Job* job = mainThreadQueue.Pop();
+		if (!job) {
+			job = GetJob();
+		}
+		if (job) {
+			ExecuteJob(job);
 		}
 	}
-	g_threadsJobQueue.clear();
+
+	isRunning = false;
+	healthMonitor.Stop();
+
+	// 唤醒所有停驻的工作线程，让它们退出 Job 循环
+	{
+		std::lock_guard<std::mutex> lock(parkMutex);
+	}
+	parkCondition.notify_all();
+
+	DetachWorkers();
+
+	if (!config.persistentWorkers) {
+		for (auto* queue : g_threadsJobQueue) {
+			DestroyLocalQueue(queue);
+		}
+		g_threadsJobQueue.clear();
+	}
 
 	delete tlthreadIndex;
+	tlthreadIndex = nullptr;
+}
+
+bool JobSystem::HasQueuedJobs(void* system) {
+	// 后台检查点：任意队列里有等待执行的 Job 即视为帧任务到达（主线程专用队列除外）
+	const JobSystem* jobSystem = static_cast<const JobSystem*>(system);
+	for (int i = 0; i < jobSystem->numThreads; i++) {
+		if (g_threadsJobQueue[i]->Size() > 0) {
+			return true;
+		}
+	}
+	return !jobSystem->criticalQueue.Empty() || !jobSystem->throughputQueue.Empty() ||
+		!jobSystem->priorityQueue.Empty() || !jobSystem->overflowQueue.Empty();
+}
+
+BackgroundTask* JobSystem::SubmitBackground(BackgroundTaskFunction func, void* userData) {
+	BackgroundTask* task = backgroundLane.Submit(func, userData);
+	if (task) {
+		WakeWorker(0);
+	}
+	return task;
+}
+
+bool JobSystem::HasPendingJobs() const {
+	// 先读完成数再读提交数：Job 的提交先于它的完成，子 Job / continuation 的提交先于父 Job 的完成，
+	// 两者相等说明读取完成数时已没有未完成的 Job，也就不会再有新的提交
+	uint64_t executed = foreignCounters.jobsExecuted.load(std::memory_order_acquire);
+	for (const ThreadSchedulerCounters& counter : counters) {
+		executed += counter.jobsExecuted.load(std::memory_order_acquire);
+	}
+	uint64_t queued = foreignCounters.jobsQueued.load(std::memory_order_acquire);
+	for (const ThreadSchedulerCounters& counter : counters) {
+		queued += counter.jobsQueued.load(std::memory_order_acquire);
+	}
+	return queued != executed;
+}
+
+void JobSystem::CountQueued() {
+	// 工作线程只写自己的计数；其他线程提交（如 continuation 在外部线程上触发主线程 Job）时计入共用计数，
+	// 否则这类 Job 的完成会被计数而提交不会，关闭时的排空判断永远不成立
+	if (tlthreadIndex != nullptr) {
+		ThreadSchedulerCounters& counter = counters[*tlthreadIndex];
+		counter.jobsQueued.store(counter.jobsQueued.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	} else {
+		foreignCounters.jobsQueued.fetch_add(1, std::memory_order_acq_rel);
+	}
+}
+
+void JobSystem::CountExecuted() {
+	if (tlthreadIndex != nullptr) {
+		ThreadSchedulerCounters& counter = counters[*tlthreadIndex];
+		counter.jobsExecuted.store(counter.jobsExecuted.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	} else {
+		foreignCounters.jobsExecuted.fetch_add(1, std::memory_order_acq_rel);
+	}
+}
 
+void JobSystem::ReadHealthCounters(void* system, uint64_t* queued, uint64_t* executed) {
+	const JobSystem* jobSystem = static_cast<const JobSystem*>(system);
+	uint64_t executedSum = jobSystem->foreignCounters.jobsExecuted.load(std::memory_order_relaxed);
+	uint64_t queuedSum = jobSystem->foreignCounters.jobsQueued.load(std::memory_order_relaxed);
+	for (const ThreadSchedulerCounters& counter : jobSystem->counters) {
+		executedSum += counter.jobsExecuted.load(std::memory_order_relaxed);
+		queuedSum += counter.jobsQueued.load(std::memory_order_relaxed);
+	}
+	*queued = queuedSum;
+	*executed = executedSum;
+}
+
+void JobSystem::AnnotateCurrentJob(JobFunction func, void* data) {
+	if (tlheartbeat) {
+		tlheartbeat->AnnotateJob(func, data);
+	}
 }
 
 #pragma endregion
@@ -76,63 +561,263 @@ void JobSystem::ShutDown()
 
 void JobSystem::WorkerThreadFunction(int threadIndex) {
 		tlthreadIndex = new int(threadIndex);
-		g_jobAllocator.Initialize(MAX_NUMBER_OF_JOBS_PERTTHREAD);
+		if (config.pinThreads) {
+			CpuTopology::PinCurrentThread(threadCpus[threadIndex]);
+		} else if (heterogeneous && config.pinCoreClasses) {
+			// 不绑定单个 CPU 时按需限制在同类核上，否则系统可能把"大核"线程调度到小核，按类分发只是尽力而为
+			topology.PinCurrentThreadToClass(threadIsBig[threadIndex] != 0);
+		}
+		// 线程池复用的线程沿用自己的队列和 Job 缓冲
+		if (!g_threadsJobQueue[threadIndex]) {
+			g_threadsJobQueue[threadIndex] = CreateLocalQueue();
+		}
+		g_jobAllocator.Initialize(MAX_NUMBER_OF_JOBS_PERTTHREAD, config.hugePages != 0);
+		readyWorkers.fetch_add(1, std::memory_order_release);
+
+		// 其他线程的队列建好之前不能窃取
+		while (readyWorkers.load(std::memory_order_acquire) < numThreads - 1) {
+			Yield();
+		}
+
+		const std::chrono::microseconds parkIdle(config.parkIdleMicros);
+		std::chrono::steady_clock::time_point idleSince;
+		bool idle = false;
 		while (isRunning) {
 			Job* job = GetJob();
 			if (job)
 			{
 				ExecuteJob(job);
+				idle = false;
+				continue;
+			}
+
+			// 没有帧 Job 时执行后台任务的一个时间片
+			if (backgroundLane.RunSlice(HasQueuedJobs, this))
+			{
+				idle = false;
+				continue;
+			}
+
+			// 连续空闲超时且活跃线程多于下限时停驻（后台通道还能接收线程时不停驻）
+			const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			if (!idle)
+			{
+				idle = true;
+				idleSince = now;
+			}
+			else if (now - idleSince >= parkIdle && !backgroundLane.CanRunSlice() && TryPark())
+			{
+				idle = false;
 			}
 		}
 		delete tlthreadIndex;
 		tlthreadIndex = nullptr;
 }
 
+bool JobSystem::TryPark() {
+	// 先占用一个"可停驻"名额，保证活跃线程不少于 minWorkers
+	int active = activeWorkers.load(std::memory_order_relaxed);
+	do {
+		if (active <= minWorkers) {
+			return false;
+		}
+	} while (!activeWorkers.compare_exchange_weak(active, active - 1, std::memory_order_acq_rel));
+
+	std::unique_lock<std::mutex> lock(parkMutex);
+	// 与 WakeWorker 配对（同 blockedWaiters）：先登记再检查队列，提交方先入队再检查登记（均为 seq_cst），
+	// 登记前入队的 Job 在这里被看到，登记后入队的由提交方唤醒
+	parkedWorkers.fetch_add(1);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (HasQueuedJobs(this)) {
+		parkedWorkers.fetch_sub(1, std::memory_order_relaxed);
+		activeWorkers.fetch_add(1, std::memory_order_acq_rel);
+		return false;
+	}
+	parkCount.fetch_add(1, std::memory_order_relaxed);
+	parkCondition.wait(lock, [this]() { return wakeRequests > 0 || !isRunning; });
+	if (wakeRequests > 0) {
+		wakeRequests--;
+	}
+	parkedWorkers.fetch_sub(1, std::memory_order_relaxed);
+	activeWorkers.fetch_add(1, std::memory_order_acq_rel);
+	return true;
+}
+
+void JobSystem::WakeWorker(size_t queueDepth) {
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (parkedWorkers.load() == 0) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(parkMutex);
+		if (wakeRequests >= parkedWorkers.load(std::memory_order_relaxed)) {
+			return;
+		}
+		wakeRequests++;
+	}
+	parkCondition.notify_one();
+	wakeCount.fetch_add(1, std::memory_order_relaxed);
+	lastWakeQueueDepth.store(static_cast<uint32_t>(queueDepth), std::memory_order_relaxed);
+}
+
+void JobSystem::GetSchedulerStats(SchedulerStats* stats) const {
+	if (!stats) return;
+
+	stats->workerCount = static_cast<uint32_t>(numThreads - 1);
+	stats->minWorkers = static_cast<uint32_t>(minWorkers);
+	stats->activeWorkers = static_cast<uint32_t>(activeWorkers.load(std::memory_order_relaxed));
+	stats->parkedWorkers = static_cast<uint32_t>(parkedWorkers.load(std::memory_order_relaxed));
+	stats->parkCount = parkCount.load(std::memory_order_relaxed);
+	stats->wakeCount = wakeCount.load(std::memory_order_relaxed);
+	stats->lastWakeQueueDepth = lastWakeQueueDepth.load(std::memory_order_relaxed);
+	stats->jobsExecuted = foreignCounters.jobsExecuted.load(std::memory_order_relaxed);
+	stats->stealAttempts = 0;
+	stats->stealSuccesses = 0;
+	for (const ThreadSchedulerCounters& counter : counters) {
+		stats->jobsExecuted += counter.jobsExecuted.load(std::memory_order_relaxed);
+		stats->stealAttempts += counter.stealAttempts.load(std::memory_order_relaxed);
+		stats->stealSuccesses += counter.stealSuccesses.load(std::memory_order_relaxed);
+	}
+}
+
+bool JobSystem::IsMainThread() const {
+	return tlthreadIndex != nullptr && *tlthreadIndex == 0;
+}
+
 WorkThreadStealQueue* JobSystem::GetWorkerThreadQueue() {
 	return g_threadsJobQueue[*tlthreadIndex];
 }
 
-Job* JobSystem::GetJob() {
+Job* JobSystem::GetJob(bool takeOverflow) {
 	WorkThreadStealQueue* queue = GetWorkerThreadQueue();
 
+	// 关键路径上的 Job 优先于本地队列和窃取
+	if (criticalPathScheduling && !priorityQueue.Empty())
+	{
+		Job* priorityJob = priorityQueue.Pop();
+		if (priorityJob != nullptr)
+		{
+			return priorityJob;
+		}
+	}
+
+	// 大小核：大核先取延迟敏感 Job，小核先取吞吐 Job
+	const bool bigCore = IsBigCoreThread(*tlthreadIndex);
+	if (heterogeneous)
+	{
+		Job* classJob = bigCore ? criticalQueue.Pop() : throughputQueue.Pop();
+		if (classJob != nullptr)
+		{
+			return classJob;
+		}
+	}
+
 	Job* job = queue->Pop();
-	if (job == nullptr)
+	if (job != nullptr)
 	{
-		// this is not a valid job because our own queue is empty, so try stealing from some other queue
-		unsigned int randomIndex = GenerateRandomNumber(0, numThreads);
-		WorkThreadStealQueue* stealQueue = g_threadsJobQueue[randomIndex];
+		return job;
+	}
 
-		// Check if the steal queue is valid and not the same as our queue
-		if (stealQueue == nullptr || stealQueue == queue)
+	// 范围协助的等待者推迟的 Job（等待者自己不取，否则会反复取回）
+	if (takeOverflow && !overflowQueue.Empty())
+	{
+		Job* overflowJob = overflowQueue.Pop();
+		if (overflowJob != nullptr)
 		{
-			// don't try to steal from ourselves or invalid queue
-			Yield();
-			return nullptr;
+			return overflowJob;
+		}
+	}
+
+	// our own queue is empty, so try stealing: nearest first (same L3, then same NUMA node, then anywhere)
+	const StealOrder& order = stealOrders[*tlthreadIndex];
+	for (int distance = 0; distance < STEAL_DISTANCE_COUNT; distance++)
+	{
+		const std::vector<int>& victims = order.victims[distance];
+		if (victims.empty())
+		{
+			continue;
 		}
 
+		ThreadSchedulerCounters& counter = counters[*tlthreadIndex];
+		counter.stealAttempts.store(counter.stealAttempts.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+		WorkThreadStealQueue* stealQueue = g_threadsJobQueue[victims[GenerateRandomNumber(0, static_cast<int>(victims.size()))]];
 		Job* stolenJob = stealQueue->Steal();
-		if (stolenJob == nullptr)
+		if (stolenJob != nullptr)
 		{
-			// we couldn't steal a job from the other queue either, so we just yield our time slice for now
-			Yield();
-			return nullptr;
+			counter.stealSuccesses.store(counter.stealSuccesses.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			return stolenJob;
 		}
+	}
 
-		return stolenJob;
+	// 本线程无事可做时才接手另一类核心的 Job
+	if (heterogeneous)
+	{
+		Job* classJob = bigCore ? throughputQueue.Pop() : criticalQueue.Pop();
+		if (classJob != nullptr)
+		{
+			return classJob;
+		}
 	}
 
-	return job;
+	// we couldn't steal a job from the other queues either, so we just yield our time slice for now
+	Yield();
+	return nullptr;
 }
 #pragma region Job生命周期
+void JobSystem::SyncFrameGeneration() {
+	// 帧号变化后切换到新一代缓冲（该槽位上一次使用的帧已由 FrameStart 确认完成，
+	// 槽位上只有帧栅栏的子孙，它们都在栅栏之前完成）
+	const uint64_t state = frameState.load(std::memory_order_acquire);
+	const uint32_t frame = static_cast<uint32_t>(state >> 32);
+	if (g_jobAllocator.GetGeneration() != frame) {
+		g_jobAllocator.FrameStart(frame, static_cast<uint32_t>(state & 0xFFFFFFFFu));
+	}
+}
+
+Job* JobSystem::AllocateJob(bool frameMemory) {
+	SyncFrameGeneration();
+	return g_jobAllocator.AllocateJob(frameMemory);
+}
+
+Job* JobSystem::GetCurrentJob() {
+	return tlcurrentJob;
+}
+
+void* JobSystem::AllocJobScratch(size_t size, size_t alignment) {
+	return g_jobAllocator.GetJobScratch().Allocate(size, alignment);
+}
+
+ScratchArena::Marker JobSystem::GetJobScratchMarker() {
+	return g_jobAllocator.GetJobScratch().GetMarker();
+}
+
+void JobSystem::ResetJobScratch(const ScratchArena::Marker& marker) {
+	g_jobAllocator.GetJobScratch().Reset(marker);
+}
+
+void* JobSystem::AllocFrameScratch(size_t size, size_t alignment) {
+	SyncFrameGeneration();
+	return g_jobAllocator.GetFrameScratch().Allocate(size, alignment);
+}
+
 Job* JobSystem::CreateJob(JobFunction func) {
-	Job* job = g_jobAllocator.AllocateJob();
+	return CreateRootJob(func, false);
+}
+
+Job* JobSystem::CreateRootJob(JobFunction func, bool frameMemory) {
+	Job* job = AllocateJob(frameMemory);
 	job->_func = func;
 	job->_parent = nullptr;
 	job->_unfinishedJob = 1;
 	job->continuationCount = 0;
+	job->flags.store(frameMemory ? JOB_FLAG_FRAME_MEMORY : 0, std::memory_order_relaxed);
+	job->priority = 0;
+	job->captureId = graphCapture.IsRecording() ? graphCapture.RecordCreate(0, func, CurrentFrameTag()) : 0;
 	// 初始化 continuations 数组
 	for (size_t i = 0; i < MAX_JOB_CONTINUATIONS; i++) {
-		job->continuations[i] = nullptr;
+		job->continuations[i].store(nullptr, std::memory_order_relaxed);
 	}
 	return job;
 }
@@ -140,54 +825,371 @@ Job* JobSystem::CreateJob(JobFunction func) {
 Job* JobSystem::CreateJob(Job* parent, JobFunction func) {
 	parent->_unfinishedJob.fetch_add(1, std::memory_order_relaxed); // �̰߳�ȫ����
 
-	Job* job = g_jobAllocator.AllocateJob();
+	// 帧栅栏的子孙分配在帧缓冲上，其余的分配在滚动环上（见 JobAllocator）
+	const uint32_t parentFlags = parent->flags.load(std::memory_order_relaxed);
+	Job* job = AllocateJob((parentFlags & JOB_FLAG_FRAME_MEMORY) != 0);
 	job->_func = func;
 	job->_parent = parent;
 	job->_unfinishedJob = 1;
 	job->continuationCount = 0;
+	// 调度提示沿父子关系继承，整条延迟敏感链都留在大核上
+	job->flags.store(parentFlags & (JOB_FLAG_HINT_MASK | JOB_FLAG_FRAME_MEMORY), std::memory_order_relaxed);
+	job->priority = 0;
+	job->captureId = graphCapture.IsRecording() ? graphCapture.RecordCreate(parent->captureId, func, CurrentFrameTag()) : 0;
 	// 初始化 continuations 数组
 	for (size_t i = 0; i < MAX_JOB_CONTINUATIONS; i++) {
-		job->continuations[i] = nullptr;
+		job->continuations[i].store(nullptr, std::memory_order_relaxed);
 	}
 	return job;
 }
 
 void JobSystem::RunJob(Job* job) {
+	CountQueued();
+	if (job->captureId != 0) {
+		graphCapture.RecordRun(job->captureId, tlthreadIndex ? *tlthreadIndex : -1);
+	}
+
+	// 主线程 Job 进入专用队列（可能由工作线程上的 continuation 触发）
+	if (job->flags.load(std::memory_order_relaxed) & JOB_FLAG_MAIN_THREAD) {
+		mainThreadQueue.Push(job);
+		return;
+	}
+
+	// 关键路径调度：带优先级的 Job 进入共享优先队列
+	if (criticalPathScheduling && job->priority != 0) {
+		priorityQueue.Push(job);
+		WakeWorker(priorityQueue.Size());
+		return;
+	}
+
+	// 带调度提示的 Job 进入对应核心类别的共享队列（同构 CPU 上忽略提示）
+	if (heterogeneous) {
+		const uint32_t hint = job->flags.load(std::memory_order_relaxed) & JOB_FLAG_HINT_MASK;
+		if (hint & JOB_FLAG_LATENCY_CRITICAL) {
+			criticalQueue.Push(job);
+			WakeWorker(criticalQueue.Size());
+			return;
+		}
+		if (hint & JOB_FLAG_THROUGHPUT) {
+			throughputQueue.Push(job);
+			WakeWorker(throughputQueue.Size());
+			return;
+		}
+	}
+
 	WorkThreadStealQueue* queue = GetWorkerThreadQueue();
 	queue->Push(job);
+
+	// 本地积压：唤醒一个停驻的工作线程来窃取
+	const size_t depth = static_cast<size_t>(queue->Size());
+	if (depth >= WAKE_QUEUE_DEPTH) {
+		WakeWorker(depth);
+	}
+}
+
+void JobSystem::RunJobInline(Job* job) {
+	// 主线程 Job 不能在其他线程执行
+	if ((job->flags.load(std::memory_order_relaxed) & JOB_FLAG_MAIN_THREAD) && !IsMainThread()) {
+		RunJob(job);
+		return;
+	}
+
+	// 与 RunJob 一样计入提交数，关闭时的排空判断依赖提交数与完成数相等
+	CountQueued();
+	if (job->captureId != 0) {
+		graphCapture.RecordRun(job->captureId, tlthreadIndex ? *tlthreadIndex : -1);
+	}
+	ExecuteJob(job);
 }
 
 void JobSystem::WaitJob(Job* job) {
-	while (!HasJobCompleted(job)) {
-		Job* nextJob = GetJob();
-		if (nextJob) {
-			ExecuteJob(nextJob);
+	if (HasJobCompleted(job)) {
+		return;
+	}
+	WaitJobs(&job, 1, true, DefaultWaitOptions());
+}
+
+JobWaitOptions JobSystem::DefaultWaitOptions() const {
+	JobWaitOptions options;
+	options.policy = static_cast<int32_t>(IsMainThread() ? mainThreadWaitPolicy : static_cast<uint32_t>(JOB_WAIT_HELP_ANY));
+	options.timeoutMicros = 0;
+	options.budgetMicros = 0;
+	options._padding = 0;
+	return options;
+}
+
+bool JobSystem::WaitAll(Job* const* jobs, uint32_t count, const JobWaitOptions& options) {
+	return WaitJobs(jobs, count, true, options) >= 0;
+}
+
+int JobSystem::WaitAny(Job* const* jobs, uint32_t count, const JobWaitOptions& options) {
+	return WaitJobs(jobs, count, false, options);
+}
+
+int JobSystem::FindCompleted(Job* const* jobs, uint32_t count, bool all) {
+	for (uint32_t i = 0; i < count; i++) {
+		const bool completed = jobs[i]->_unfinishedJob.load() == 0;
+		if (all && !completed) return -1;
+		if (!all && completed) return static_cast<int>(i);
+	}
+	return all ? 0 : -1;
+}
+
+bool JobSystem::InWaitScope(const Job* job, Job* const* jobs, uint32_t count) {
+	// 被等待 Job 的子孙都还未完成，父链上的指针有效
+	for (const Job* current = job; current != nullptr; current = current->_parent) {
+		for (uint32_t i = 0; i < count; i++) {
+			if (current == jobs[i]) return true;
 		}
 	}
+	return false;
+}
+
+int JobSystem::WaitJobs(Job* const* jobs, uint32_t count, bool all, const JobWaitOptions& options) {
+	if (count == 0) {
+		return all ? 0 : -1;
+	}
+	int completed = FindCompleted(jobs, count, all);
+	if (completed >= 0) {
+		return completed;
+	}
+	WaitHeartbeatScope waitScope(tlthreadIndex ? &heartbeats[*tlthreadIndex] : nullptr, jobs[0]->_func);
+
+	uint32_t policy = static_cast<uint32_t>(options.policy);
+	if (tlthreadIndex == nullptr) {
+		// 非工作线程没有队列，只能阻塞
+		policy = JOB_WAIT_BLOCK;
+	} else if (numThreads == 1 && (policy == JOB_WAIT_HELP_SUBTREE || policy == JOB_WAIT_HELP_BUDGET)) {
+		// 没有别的线程接手被推迟的 Job
+		policy = JOB_WAIT_HELP_ANY;
+	}
+
+	const bool hasDeadline = options.timeoutMicros > 0;
+	std::chrono::steady_clock::time_point start;
+	if (hasDeadline || policy == JOB_WAIT_HELP_BUDGET) {
+		start = std::chrono::steady_clock::now();
+	}
+	const std::chrono::steady_clock::time_point deadline = start + std::chrono::microseconds(options.timeoutMicros);
+
+	if (policy == JOB_WAIT_BLOCK) {
+		// 与 FinishJob 的唤醒配对：先登记再检查，FinishJob 先完成计数再检查登记（均为 seq_cst）
+		blockedWaiters.fetch_add(1);
+		{
+			std::unique_lock<std::mutex> lock(completionMutex);
+			auto ready = [&]() { return (completed = FindCompleted(jobs, count, all)) >= 0; };
+			if (hasDeadline) {
+				completionCondition.wait_until(lock, deadline, ready);
+			} else {
+				completionCondition.wait(lock, ready);
+			}
+		}
+		blockedWaiters.fetch_sub(1);
+		return completed;
+	}
+
+	const std::chrono::steady_clock::time_point budgetEnd = start + std::chrono::microseconds(options.budgetMicros);
+	const bool mainThread = IsMainThread();
+	uint64_t overflowScanned = ~0ull;
+	for (;;) {
+		Job* job = TakeHelpJob(jobs, count, policy, budgetEnd, mainThread, overflowScanned);
+		if (job) {
+			ExecuteJob(job);
+		}
+
+		completed = FindCompleted(jobs, count, all);
+		if (completed >= 0) {
+			return completed;
+		}
+		if (hasDeadline && std::chrono::steady_clock::now() >= deadline) {
+			return -1;
+		}
+	}
+}
+
+Job* JobSystem::TakeHelpJob(Job* const* jobs, uint32_t count, uint32_t policy,
+	std::chrono::steady_clock::time_point budgetEnd, bool mainThread, uint64_t& overflowScanned) {
+	// 主线程 Job 只能由主线程执行，等待依赖它们的 Job 时不执行会死锁，不受策略限制
+	if (mainThread) {
+		Job* job = mainThreadQueue.Pop();
+		if (job) {
+			return job;
+		}
+	}
+
+	Job* job = GetJob(policy == JOB_WAIT_HELP_ANY);
+	if (!job) {
+		// 其他范围等待者推迟的 Job 可能属于本次等待的子树；所有线程都在范围等待时只能靠这里取回
+		// 扫描要加锁并遍历父链，只在上次扫描后有新 Job 入队时重新扫描
+		if (policy != JOB_WAIT_HELP_ANY) {
+			const uint64_t pushes = overflowQueue.PushCount();
+			if (pushes != overflowScanned) {
+				overflowScanned = pushes;
+				job = overflowQueue.PopMatching([jobs, count](const Job* candidate) {
+					return InWaitScope(candidate, jobs, count);
+				});
+				if (job) {
+					// 取走一个后可能还有其他匹配的 Job
+					overflowScanned = ~0ull;
+				}
+			}
+		}
+		return job;
+	}
+	if (policy == JOB_WAIT_HELP_ANY || InWaitScope(job, jobs, count)) {
+		return job;
+	}
+
+	// 没有耗时历史的 Job 按超出预算处理
+	if (policy == JOB_WAIT_HELP_BUDGET) {
+		const std::chrono::nanoseconds estimate(JobDurationHistory::Estimate(job->_func));
+		if (estimate.count() > 0 && std::chrono::steady_clock::now() + estimate < budgetEnd) {
+			return job;
+		}
+	}
+
+	// 不相关的 Job 交给其他线程（它们可能正停驻）
+	overflowQueue.Push(job);
+	WakeWorker(overflowQueue.Size());
+	return nullptr;
+}
+
+void JobSystem::SetMainThreadOnly(Job* job) {
+	job->flags.fetch_or(JOB_FLAG_MAIN_THREAD, std::memory_order_relaxed);
+}
+
+void JobSystem::SetSchedulingHint(Job* job, uint32_t hint) {
+	job->flags.fetch_and(~JOB_FLAG_HINT_MASK, std::memory_order_relaxed);
+	job->flags.fetch_or(hint & JOB_FLAG_HINT_MASK, std::memory_order_relaxed);
+}
+
+int JobSystem::PumpMainThread() {
+	if (!IsMainThread()) {
+		return 0;
+	}
+
+	int executed = 0;
+	while (Job* job = mainThreadQueue.Pop()) {
+		ExecuteJob(job);
+		executed++;
+	}
+	return executed;
 }
 void JobSystem::ExecuteJob(Job* job) {
-	(job->_func)(job, job->data);
+	// 关闭时丢弃：按取消处理，RUN_ON_CANCEL 的函数通过 IsCancelled 看到取消
+	if (discardPending.load(std::memory_order_relaxed)) {
+		job->flags.fetch_or(JOB_FLAG_CANCELLED, std::memory_order_relaxed);
+	}
+
+	// 已取消的 Job 跳过函数，但仍要完成计数，父 Job 和 continuation 才能继续
+	if (!IsCancelled(job) || (job->flags.load(std::memory_order_relaxed) & JOB_FLAG_RUN_ON_CANCEL)) {
+		// Job 级临时内存随函数返回回退（嵌套执行的 Job 按栈顺序回退）
+		ScratchArena& scratch = g_jobAllocator.GetJobScratch();
+		const ScratchArena::Marker marker = scratch.GetMarker();
+
+		// 图捕获：记录执行区间，函数内创建的 Job 以它为创建者
+		const uint32_t captureId = job->captureId;
+		uint32_t outerCaptureJob = 0;
+		if (captureId != 0) {
+			graphCapture.RecordStart(captureId, tlthreadIndex ? *tlthreadIndex : -1);
+			outerCaptureJob = JobGraphCapture::GetCurrentJob();
+			JobGraphCapture::SetCurrentJob(captureId);
+		}
+
+		// 健康监视：标记心跳（嵌套执行时只记录最外层 Job）
+		ThreadHeartbeat* outerHeartbeat = tlheartbeat;
+		if (tlthreadIndex != nullptr) {
+			tlheartbeat = &heartbeats[*tlthreadIndex];
+			tlheartbeat->BeginJob(job->_func, job->data);
+		}
+
+		Job* outerJob = tlcurrentJob;
+		tlcurrentJob = job;
+		if (++tldurationSample % DURATION_SAMPLE_INTERVAL == 0) {
+			const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+			(job->_func)(job, job->data);
+			const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - begin;
+			JobDurationHistory::Record(job->_func,
+				static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+		} else {
+			(job->_func)(job, job->data);
+		}
+		tlcurrentJob = outerJob;
+
+		if (tlthreadIndex != nullptr) {
+			tlheartbeat->EndJob();
+		}
+		tlheartbeat = outerHeartbeat;
+
+		if (captureId != 0) {
+			JobGraphCapture::SetCurrentJob(outerCaptureJob);
+			graphCapture.RecordEnd(captureId);
+		}
+		scratch.Reset(marker);
+	}
 	FinishJob(job);
+
+	// 完成计数放在 FinishJob 之后：它触发的 continuation 已经计入提交数
+	CountExecuted();
+}
+
+void JobSystem::CancelJob(Job* job) {
+	job->flags.fetch_or(JOB_FLAG_CANCELLED, std::memory_order_release);
+}
+
+bool JobSystem::IsCancelled(const Job* job) {
+	// 取消标记在祖先上，沿父链向上查找（链通常很短）
+	for (const Job* current = job; current != nullptr; current = current->_parent) {
+		if (current->flags.load(std::memory_order_acquire) & JOB_FLAG_CANCELLED) {
+			return true;
+		}
+	}
+	return false;
 }
 
 void JobSystem::AddContinuation(Job* job, Job* continuation) {
+	if (job->captureId != 0 && continuation->captureId != 0) {
+		graphCapture.RecordEdge(job->captureId, continuation->captureId);
+	}
+
 	// 原子地增加 continuation 计数并获取索引
-	const int32_t index = job->continuationCount.fetch_add(1, std::memory_order_relaxed);
+	const int32_t index = job->continuationCount.fetch_add(1, std::memory_order_acq_rel);
+
+	// 已封口：job 已经完成（例如上一帧的栅栏），continuation 直接运行
+	if (index >= JOB_CONTINUATIONS_SEALED) {
+		RunJob(continuation);
+		return;
+	}
 
 	// 检查是否超出最大 continuation 数量
-	if (index >= MAX_JOB_CONTINUATIONS) {
-		// 超出限制，可以选择抛出异常或记录错误
-		// 这里简单处理：减回计数
-		job->continuationCount.fetch_sub(1, std::memory_order_relaxed);
+	if (index >= static_cast<int32_t>(MAX_JOB_CONTINUATIONS)) {
+		// 超出限制，忽略该 continuation（FinishJob 只读取前 MAX_JOB_CONTINUATIONS 项）
 		return;
 	}
 
 	// 将 continuation 添加到数组中
-	job->continuations[index] = continuation;
+	job->continuations[index].store(continuation, std::memory_order_release);
+}
+
+void JobSystem::OpenLog() {
+	// 调用方持有 logMutex
+	logOpened = true;
+	logFile.open("JobSystemDebug.txt", std::ios::out | std::ios::trunc);
+	if (logFile.is_open()) {
+		logFile << "=== JobSystem Debug Log ===\n";
+		logFile << "Initialized with " << numThreads << " threads\n";
+		for (int i = 0; i < numThreads; i++) {
+			logFile << "  thread " << i << " -> cpu " << threadCpus[i] << (threadIsBig[i] ? " (big)" : " (little)") << "\n";
+		}
+		logFile << "============================\n\n";
+		logFile.flush();
+	}
 }
 
 void JobSystem::Log(const char* message) {
 	std::lock_guard<std::mutex> lock(logMutex);
+	if (!logOpened) {
+		OpenLog();
+	}
 	if (logFile.is_open()) {
 		logFile << message;
 		logFile.flush();
@@ -198,16 +1200,31 @@ void JobSystem::Log(const char* message) {
 /// </summary>
 /// <param name="job"></param>
 void JobSystem::FinishJob(Job* job) {
-	const int32_t unfinishedJobs = job->_unfinishedJob.fetch_sub(1, std::memory_order_relaxed) - 1;
+	// seq_cst：与阻塞等待者"先登记、再检查完成"配对，保证两边至少有一方看到对方
+	const int32_t unfinishedJobs = job->_unfinishedJob.fetch_sub(1) - 1;
 	if (unfinishedJobs == 0)
 	{
-		// 触发所有 continuations
-		const int32_t count = job->continuationCount.load(std::memory_order_relaxed);
+		// 封口并触发所有 continuations：封口前已占位的槽位可能还未写入，等待写入完成
+		int32_t count = job->continuationCount.exchange(JOB_CONTINUATIONS_SEALED, std::memory_order_acq_rel);
+		if (count > static_cast<int32_t>(MAX_JOB_CONTINUATIONS)) {
+			count = static_cast<int32_t>(MAX_JOB_CONTINUATIONS);
+		}
 		for (int32_t i = 0; i < count; i++) {
-			Job* continuation = job->continuations[i];
-			if (continuation != nullptr) {
-				RunJob(continuation);
+			Job* continuation = job->continuations[i].load(std::memory_order_acquire);
+			while (continuation == nullptr) {
+				Yield();
+				continuation = job->continuations[i].load(std::memory_order_acquire);
+			}
+			RunJob(continuation);
+		}
+
+		// 唤醒阻塞等待者（没有等待者时只多一次原子读）
+		if (blockedWaiters.load() > 0)
+		{
+			{
+				std::lock_guard<std::mutex> lock(completionMutex);
 			}
+			completionCondition.notify_all();
 		}
 
 		// 通知父 Job
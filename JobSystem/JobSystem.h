@@ -5,47 +5,246 @@
 #include <atomic>
 #include <fstream>
 #include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include "Job.h"
 #include "WorkThreadStealQueue.h"
 #include "JobAllocator.h"
+#include "JobSystemConfig.h"
+#include "CpuTopology.h"
+#include "JobGraphCapture.h"
+#include "BackgroundLane.h"
+#include "HealthMonitor.h"
 
 
 
+// 每个线程的调度计数（只由所属线程写入，填充到一条缓存行）
+struct ThreadSchedulerCounters {
+	std::atomic<uint64_t> jobsQueued;            // 本线程 RunJob 的次数
+	std::atomic<uint64_t> jobsExecuted;          // 本线程执行完成的次数（函数和 FinishJob 都已返回）
+	std::atomic<uint64_t> stealAttempts;
+	std::atomic<uint64_t> stealSuccesses;
+	char padding[64 - sizeof(std::atomic<uint64_t>) * 4];
+
+	ThreadSchedulerCounters() : jobsQueued(0), jobsExecuted(0), stealAttempts(0), stealSuccesses(0), padding() {}
+};
+
+// 调度器统计快照
+struct SchedulerStats {
+	uint32_t workerCount;          // 工作线程总数（不含主线程）
+	uint32_t minWorkers;
+	uint32_t activeWorkers;
+	uint32_t parkedWorkers;
+	uint64_t parkCount;            // 累计停驻次数（空闲超时）
+	uint64_t wakeCount;            // 累计唤醒次数（队列积压）
+	uint32_t lastWakeQueueDepth;   // 最近一次唤醒时触发队列的长度
+	uint64_t jobsExecuted;
+	uint64_t stealAttempts;
+	uint64_t stealSuccesses;
+};
+
+// 每个线程的窃取顺序：按拓扑距离分级的候选线程索引
+struct StealOrder {
+	std::vector<int> victims[STEAL_DISTANCE_COUNT];
+};
+
 class JobSystem {
 private:
-	std::vector<std::thread> workerThreads;
 	std::atomic<bool> isRunning;
 	int numThreads;
 
+	// 拓扑：线程 i 分配到 threadCpus[i]，由近及远窃取
+	JobSystemConfig config;
+	CpuTopology topology;
+	std::vector<int> threadCpus;
+	std::vector<StealOrder> stealOrders;
+	std::atomic<int> readyWorkers;               // 已在本线程上建好队列和 Job 缓冲的工作线程数
+
+	// 大小核：heterogeneous 为 true 时带调度提示的 Job 进入按核心类别划分的共享队列
+	bool heterogeneous;
+	std::vector<uint8_t> threadIsBig;            // 线程 i 所分配的 CPU 是否为大核（主线程视为大核）
+	SharedJobQueue criticalQueue;                // 延迟敏感：大核优先取，小核空闲时兜底
+	SharedJobQueue throughputQueue;              // 吞吐：小核优先取，大核空闲时兜底
+
+	// 关键路径调度：priority 非 0 的 Job 进入共享优先队列，所有线程先从这里取
+	bool criticalPathScheduling;
+	PriorityJobQueue priorityQueue;
+
+	// 等待：范围协助时不相关的 Job 转入溢出队列由其他线程执行；阻塞等待在 Job 完成时被唤醒
+	uint32_t mainThreadWaitPolicy;
+	SharedJobQueue overflowQueue;
+	std::mutex completionMutex;
+	std::condition_variable completionCondition;
+	std::atomic<int> blockedWaiters;
+
+	// 弹性线程数：空闲超时的工作线程停驻在条件变量上，队列积压时唤醒
+	int minWorkers;
+	std::atomic<int> activeWorkers;
+	std::atomic<int> parkedWorkers;
+	std::mutex parkMutex;
+	std::condition_variable parkCondition;
+	int wakeRequests;                            // 由 parkMutex 保护
+	std::atomic<uint64_t> parkCount;
+	std::atomic<uint64_t> wakeCount;
+	std::atomic<uint32_t> lastWakeQueueDepth;
+	std::vector<ThreadSchedulerCounters> counters;
+	ThreadSchedulerCounters foreignCounters;     // 不属于本实例的线程（没有线程索引）共用，原子加
+
+	// 关闭：丢弃模式下所有未执行的 Job 按取消处理
+	std::atomic<bool> discardPending;
+
 	// 日志相关
 	std::ofstream logFile;
 	std::mutex logMutex;
+	bool logOpened;                              // 由 logMutex 保护；deferLogOpen 时第一次 Log 才打开
 	int frameCounter;
 
+	// 帧流水线：每帧一个栅栏 Job，最多 pipelineDepth 帧同时在途
+	std::atomic<uint64_t> frameState;            // (帧号 << 32) | Job 缓冲槽位，工作线程据此切换分配代
+	uint32_t currentFrame;
+	uint32_t currentSlot;
+	uint32_t pipelineDepth;
+	uint32_t drainedFrame;                       // 此帧及之前的帧都已确认完成
+	bool frameOpen;
+	Job* frameFences[MAX_FRAMES_IN_FLIGHT];
+
+	// Job 图捕获：captureArmed 时下一次 FrameStart 开始记录，最后一帧完成后写出文件
+	JobGraphCapture graphCapture;
+	bool captureArmed;
+	std::string capturePath;
+	uint32_t captureFrames;
+	uint32_t captureMaxJobs;
+
+	// 主线程专用队列：工作线程不会取走，由主线程在 WaitJob / FrameEnd / PumpMainThread 中执行
+	SharedJobQueue mainThreadQueue;
+
+	// 后台通道：工作线程取不到 Job 时执行长任务的时间片，有 Job 到达时在检查点让出
+	BackgroundLane backgroundLane;
+
+	// 健康监视：每个线程的心跳由监视线程采样（注册回调后才启动监视线程）
+	std::vector<ThreadHeartbeat> heartbeats;
+	HealthMonitor healthMonitor;
+
 public:
 #pragma region JobSystem��������
 	void Initialize();
+	void Initialize(const JobSystemConfig& config);
+	static JobSystemConfig DefaultConfig();
 	void FrameStart();
 	void FrameEnd();
 	void ShutDown();
+
+	// 设置同时在途的帧数 [1, MAX_FRAMES_IN_FLIGHT - 1]，会先等待已结束的在途帧完成
+	void SetPipelineDepth(uint32_t depth);
+	uint32_t GetPipelineDepth() const { return pipelineDepth; }
+	uint32_t GetFrameIndex() const { return currentFrame; }
+	// 参与执行 Job 的线程数（含主线程）
+	int GetThreadCount() const { return numThreads; }
+	// 线程 threadIndex 分配到的逻辑 CPU（0 为主线程）
+	int GetThreadCpu(int threadIndex) const { return threadCpus[threadIndex]; }
+	// CPU 是否为大小核混合（否则调度提示被忽略）
+	bool IsHeterogeneous() const { return heterogeneous; }
+	bool IsBigCoreThread(int threadIndex) const { return threadIsBig[threadIndex] != 0; }
+	// 调度器统计（线程数、停驻 / 唤醒决策、执行和窃取计数）
+	void GetSchedulerStats(SchedulerStats* stats) const;
+	// 结束进程级线程池中的空闲工作线程（persistentWorkers），仍有实例在使用时返回 false
+	// 插件卸载前调用；不调用时线程在进程退出时结束
+	static bool ReleaseWorkerPool();
+	// 从下一次 FrameStart 起捕获 frameCount 帧的 Job 图（创建、父子、continuation、执行线程和时间），
+	// 最后一帧完成后写入 path；frameCount 为 0 时立即开始，直到 EndGraphCapture
+	// maxJobs 为记录上限（0 表示默认值），捕获进行中时返回 false
+	bool BeginGraphCapture(const char* path, uint32_t frameCount, uint32_t maxJobs = 0);
+	// 提前结束捕获：等待在途帧完成后写出文件，没有进行中的捕获或写入失败时返回 false
+	bool EndGraphCapture();
+	// 当前帧栅栏：本帧的 Job 作为它的子 Job 创建，FrameEnd 后栅栏在所有子 Job 完成时完成
+	Job* GetFrameFence();
+	// 上一帧栅栏：帧间依赖通过 AddContinuation(GetPreviousFrameFence(), job) 表达
+	Job* GetPreviousFrameFence();
 #pragma endregion
 
 #pragma region Job��������
 	Job* CreateJob(JobFunction func);
 	Job* CreateJob(Job* parent, JobFunction func);
 	void RunJob(Job* job); // �о������������Ǻܺã�Run����Job�б�ִ�е�����
+	// 不入队，直接在当前线程执行（fork-join 中的最后一个分支）
+	void RunJobInline(Job* job);
 	void WaitJob(Job* job);
+	// 等待 jobs 全部完成，超时返回 false；options 见 JobWaitPolicy
+	// 非工作线程（没有队列）总是阻塞等待；正在执行的 Job 不会被打断，超时只在两次执行之间检查
+	bool WaitAll(Job* const* jobs, uint32_t count, const JobWaitOptions& options);
+	// 等待 jobs 中任意一个完成，返回它的下标，超时返回 -1
+	int WaitAny(Job* const* jobs, uint32_t count, const JobWaitOptions& options);
+	// WaitJob 使用的参数：主线程为 mainThreadWaitPolicy，其他工作线程为 JOB_WAIT_HELP_ANY，不限时
+	JobWaitOptions DefaultWaitOptions() const;
 	void ExecuteJob(Job* job);
 	void FinishJob(Job* job);
 	void AddContinuation(Job* job, Job* continuation);
+	// 取消 job 及其所有子孙 Job：尚未执行的跳过函数（仍完成计数），continuation 不受影响
+	void CancelJob(Job* job);
+	// job 或其任一祖先被取消时返回 true，长时间运行的函数可以轮询它提前退出
+	static bool IsCancelled(const Job* job);
+	// 标记 job 只能在主线程执行（需在 RunJob 或触发它的 continuation 之前调用）
+	static void SetMainThreadOnly(Job* job);
+	// 设置调度提示 JOB_FLAG_LATENCY_CRITICAL / JOB_FLAG_THROUGHPUT（0 清除），之后创建的子 Job 继承
+	static void SetSchedulingHint(Job* job, uint32_t hint);
+	// 在主线程上执行所有已就绪的主线程 Job，返回执行数量（非主线程调用时什么都不做）
+	int PumpMainThread();
+	// 当前线程正在执行的 Job（嵌套执行时为最内层），Job 之外返回 nullptr
+	static Job* GetCurrentJob();
+	// 当前线程的 Job 级临时内存：当前 Job 函数返回时自动回收（Job 之外调用则到下一次 FrameStart）
+	static void* AllocJobScratch(size_t size, size_t alignment = 16);
+	// Job 级临时内存的回退点：临时数据生命周期短于当前 Job 时（如 TaskGroup 的闭包）可提前回收
+	static ScratchArena::Marker GetJobScratchMarker();
+	static void ResetJobScratch(const ScratchArena::Marker& marker);
+	// 当前线程的帧级临时内存：本帧栅栏完成前一直有效，可以跨 Job 传递
+	void* AllocFrameScratch(size_t size, size_t alignment = 16);
 	void Log(const char* message);
+
+	// 提交后台任务：func(userData) 被反复调用直到返回非 0，可以跨任意多帧
+	// 返回的句柄用 BackgroundLane::GetState 查询、BackgroundLane::Cancel 取消，不再使用时 BackgroundLane::Release
+	// 只有一个线程时后台任务在 FrameEnd 中每帧执行一个时间片
+	BackgroundTask* SubmitBackground(BackgroundTaskFunction func, void* userData);
+	// 后台任务的检查点：返回 true 时任务应保存进度并返回 0
+	static bool BackgroundShouldYield() { return BackgroundLane::ShouldYield(); }
+	void GetBackgroundStats(BackgroundStats* stats) const { backgroundLane.GetStats(stats); }
+
+	// 注册健康监视回调（nullptr 清除），在监视线程上调用；返回后旧回调不会再被调用
+	// 第一次注册时启动监视线程（healthIntervalMicros 为 0 时不启动）
+	void SetHealthCallback(JobHealthCallback callback, void* userData) { healthMonitor.SetCallback(callback, userData); }
+	// 替换健康监视报告的当前 Job 函数和数据（适配层在调用真实回调前设置），只对线程上最外层的 Job 生效
+	static void AnnotateCurrentJob(JobFunction func, void* data);
 #pragma endregion
 
 
 private:
+	static void PoolThreadFunction(int threadIndex);
 	void WorkerThreadFunction(int threadIndex);
+	void AttachWorkers();
+	void DetachWorkers();
+	bool HasPendingJobs() const;
+	void CountQueued();
+	void CountExecuted();
+	static bool HasQueuedJobs(void* system);
+	static void ReadHealthCounters(void* system, uint64_t* queued, uint64_t* executed);
+	void OpenLog();
+	void BuildStealOrders();
+	bool TryPark();
+	void WakeWorker(size_t queueDepth);
+	static WorkThreadStealQueue* CreateLocalQueue();
+	static void DestroyLocalQueue(WorkThreadStealQueue* queue);
+	Job* AllocateJob(bool frameMemory);
+	Job* CreateRootJob(JobFunction func, bool frameMemory);
+	void SyncFrameGeneration();
+	void DrainFrames();
 	WorkThreadStealQueue* GetWorkerThreadQueue();
-	Job* GetJob();
+	Job* GetJob(bool takeOverflow = true);
+	int WaitJobs(Job* const* jobs, uint32_t count, bool all, const JobWaitOptions& options);
+	Job* TakeHelpJob(Job* const* jobs, uint32_t count, uint32_t policy,
+		std::chrono::steady_clock::time_point budgetEnd, bool mainThread, uint64_t& overflowScanned);
+	static int FindCompleted(Job* const* jobs, uint32_t count, bool all);
+	static bool InWaitScope(const Job* job, Job* const* jobs, uint32_t count);
+	bool IsMainThread() const;
+	uint32_t CurrentFrameTag() const { return static_cast<uint32_t>(frameState.load(std::memory_order_relaxed) >> 32); }
 	bool HasJobCompleted(Job* job) { return job->_unfinishedJob == 0; }
 private:
 	void Yield() { std::this_thread::yield(); }
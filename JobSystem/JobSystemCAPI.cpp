@@ -2,6 +2,10 @@
 #include "JobSystem.h"
 #include "Profiler.h"
 #include "ParallelForC.h"  // 使用 C 风格版本，避免 std::function/lambda 问题
+#include "ParallelRange.h"
+#include "JobGraph.h"
+#include "ParallelPipeline.h"
+#include "ParallelMemory.h"
 #include <new>
 
 // 包装结构，用于存储回调和用户数据
@@ -57,10 +61,13 @@ static void ParallelForCAdapterFunc(void* data, uint32_t count, void* userData)
 }
 
 // 内部适配函数：将 C++ JobFunction 转换为 C 回调
+// 该 Job 带 JOB_FLAG_RUN_ON_CANCEL：取消后不调用回调，但仍释放 wrapper
 static void JobFunctionAdapter(Job* job, void* data) {
     if (data) {
         JobCallbackWrapper* wrapper = static_cast<JobCallbackWrapper*>(data);
-        if (wrapper->callback) {
+        if (wrapper->callback && !JobSystem::IsCancelled(job)) {
+            // 健康监视报告真实回调，而不是适配函数
+            JobSystem::AnnotateCurrentJob(wrapper->callback, wrapper->userData);
             wrapper->callback(job, wrapper->userData);
         }
         delete wrapper;
@@ -78,6 +85,20 @@ JOBSYSTEM_C_API JobSystem* JobSystem_Create() {
     return system;
 }
 
+JOBSYSTEM_C_API void JobSystem_GetDefaultConfig(JobSystemConfig* config) {
+    if (config) {
+        *config = JobSystem::DefaultConfig();
+    }
+}
+
+JOBSYSTEM_C_API JobSystem* JobSystem_CreateEx(const JobSystemConfig* config) {
+    JobSystem* system = new (std::nothrow) JobSystem();
+    if (system) {
+        system->Initialize(config ? *config : JobSystem::DefaultConfig());
+    }
+    return system;
+}
+
 JOBSYSTEM_C_API void JobSystem_Destroy(JobSystem* system) {
     if (system) {
         system->ShutDown();
@@ -85,6 +106,10 @@ JOBSYSTEM_C_API void JobSystem_Destroy(JobSystem* system) {
     }
 }
 
+JOBSYSTEM_C_API int JobSystem_ReleaseWorkerPool(void) {
+    return JobSystem::ReleaseWorkerPool() ? 1 : 0;
+}
+
 JOBSYSTEM_C_API void JobSystem_FrameStart(JobSystem* system) {
     if (system) {
         system->FrameStart();
@@ -97,6 +122,24 @@ JOBSYSTEM_C_API void JobSystem_FrameEnd(JobSystem* system) {
     }
 }
 
+JOBSYSTEM_C_API void JobSystem_SetPipelineDepth(JobSystem* system, uint32_t depth) {
+    if (system) {
+        system->SetPipelineDepth(depth);
+    }
+}
+
+JOBSYSTEM_C_API uint32_t JobSystem_GetFrameIndex(JobSystem* system) {
+    return system ? system->GetFrameIndex() : 0;
+}
+
+JOBSYSTEM_C_API Job* JobSystem_GetFrameFence(JobSystem* system) {
+    return system ? system->GetFrameFence() : nullptr;
+}
+
+JOBSYSTEM_C_API Job* JobSystem_GetPreviousFrameFence(JobSystem* system) {
+    return system ? system->GetPreviousFrameFence() : nullptr;
+}
+
 // ====== Job 操作 ======
 
 JOBSYSTEM_C_API Job* JobSystem_CreateJob(JobSystem* system, JobCallback callback, void* userData) {
@@ -112,6 +155,7 @@ JOBSYSTEM_C_API Job* JobSystem_CreateJob(JobSystem* system, JobCallback callback
     Job* job = system->CreateJob(JobFunctionAdapter);
     if (job) {
         job->data = wrapper;
+        job->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
     } else {
         delete wrapper;
     }
@@ -132,6 +176,7 @@ JOBSYSTEM_C_API Job* JobSystem_CreateChildJob(JobSystem* system, Job* parent, Jo
     Job* job = system->CreateJob(parent, JobFunctionAdapter);
     if (job) {
         job->data = wrapper;
+        job->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
     } else {
         delete wrapper;
     }
@@ -151,12 +196,61 @@ JOBSYSTEM_C_API void JobSystem_WaitJob(JobSystem* system, Job* job) {
     }
 }
 
+JOBSYSTEM_C_API int JobSystem_WaitAll(JobSystem* system, Job* const* jobs, uint32_t count, const JobWaitOptions* options) {
+    if (!system || (!jobs && count > 0)) {
+        return 0;
+    }
+    return system->WaitAll(jobs, count, options ? *options : system->DefaultWaitOptions()) ? 1 : 0;
+}
+
+JOBSYSTEM_C_API int JobSystem_WaitAny(JobSystem* system, Job* const* jobs, uint32_t count, const JobWaitOptions* options) {
+    if (!system || !jobs || count == 0) {
+        return -1;
+    }
+    return system->WaitAny(jobs, count, options ? *options : system->DefaultWaitOptions());
+}
+
 JOBSYSTEM_C_API void JobSystem_AddContinuation(JobSystem* system, Job* job, Job* continuation) {
     if (system && job && continuation) {
         system->AddContinuation(job, continuation);
     }
 }
 
+JOBSYSTEM_C_API void JobSystem_CancelJob(JobSystem* system, Job* job) {
+    if (system && job) {
+        system->CancelJob(job);
+    }
+}
+
+JOBSYSTEM_C_API int Job_IsCancelled(Job* job) {
+    return (job && JobSystem::IsCancelled(job)) ? 1 : 0;
+}
+
+JOBSYSTEM_C_API void Job_SetMainThreadOnly(Job* job) {
+    if (job) {
+        JobSystem::SetMainThreadOnly(job);
+    }
+}
+
+JOBSYSTEM_C_API void Job_SetSchedulingHint(Job* job, int hint) {
+    if (!job) {
+        return;
+    }
+
+    uint32_t flags = 0;
+    if (hint == JOB_HINT_LATENCY_CRITICAL) flags = JOB_FLAG_LATENCY_CRITICAL;
+    else if (hint == JOB_HINT_THROUGHPUT) flags = JOB_FLAG_THROUGHPUT;
+    JobSystem::SetSchedulingHint(job, flags);
+}
+
+JOBSYSTEM_C_API int JobSystem_IsHeterogeneous(JobSystem* system) {
+    return system && system->IsHeterogeneous() ? 1 : 0;
+}
+
+JOBSYSTEM_C_API int JobSystem_PumpMainThread(JobSystem* system) {
+    return system ? system->PumpMainThread() : 0;
+}
+
 JOBSYSTEM_C_API void* Job_GetUserData(Job* job) {
     if (!job || !job->data) return nullptr;
 
@@ -171,6 +265,27 @@ JOBSYSTEM_C_API void Job_SetUserData(Job* job, void* userData) {
     }
 }
 
+JOBSYSTEM_C_API void* Job_AllocScratch(Job* job, size_t size, size_t alignment) {
+    if (!job) {
+        return nullptr;
+    }
+    return JobSystem::AllocJobScratch(size, alignment);
+}
+
+JOBSYSTEM_C_API void* JobSystem_GetScratch(JobSystem* system, size_t size, size_t alignment) {
+    if (!system) {
+        return nullptr;
+    }
+    return JobSystem::AllocJobScratch(size, alignment);
+}
+
+JOBSYSTEM_C_API void* JobSystem_AllocFrameScratch(JobSystem* system, size_t size, size_t alignment) {
+    if (!system) {
+        return nullptr;
+    }
+    return system->AllocFrameScratch(size, alignment);
+}
+
 // Profiler API
 JOBSYSTEM_C_API void Profiler_BeginSession(const char* filepath) {
     Profiler::Instance().BeginSession(filepath);
@@ -180,6 +295,14 @@ JOBSYSTEM_C_API void Profiler_EndSession() {
     Profiler::Instance().EndSession();
 }
 
+JOBSYSTEM_C_API int JobSystem_BeginGraphCapture(JobSystem* system, const char* path, uint32_t frameCount, uint32_t maxJobs) {
+    return system && system->BeginGraphCapture(path, frameCount, maxJobs) ? 1 : 0;
+}
+
+JOBSYSTEM_C_API int JobSystem_EndGraphCapture(JobSystem* system) {
+    return system && system->EndGraphCapture() ? 1 : 0;
+}
+
 // ====== Parallel For 实现 ======
 
 JOBSYSTEM_C_API Job* JobSystem_ParallelFor(
@@ -218,7 +341,8 @@ JOBSYSTEM_C_API Job* JobSystem_ParallelFor(
         static_cast<uint32_t>(elementSize),
         ParallelForCAdapterFunc,  // 使用适配器函数
         wrapper,                   // 将 wrapper 作为 userData 传递
-        *splitter
+        *splitter,
+        reinterpret_cast<const void*>(callback)  // 自动分块按 delegate 区分调用点
     );
 
     // 创建清理 Job，使用 continuation 确保在 rootJob 完成后执行
@@ -240,6 +364,47 @@ JOBSYSTEM_C_API Job* JobSystem_ParallelFor(
     return rootJob;
 }
 
+JOBSYSTEM_C_API uint32_t JobSystem_GetAutoBatchSize(const void* callback, float* nanosPerElement) {
+    const ParallelForTuning* tuning = parallel_for_peek_tuning(callback);
+    if (nanosPerElement) {
+        *nanosPerElement = tuning ? tuning->nanosPerElement.load(std::memory_order_relaxed) : 0.0f;
+    }
+    return tuning ? tuning->batchSize.load(std::memory_order_relaxed) : 0;
+}
+
+JOBSYSTEM_C_API void JobSystem_GetAllocatorStats(JobSystemAllocatorStats* stats) {
+    if (!stats) return;
+
+    SlabAllocatorStats total;
+    SlabAllocator::GetTotalStats(&total);
+    stats->allocations = total.allocations;
+    stats->localFrees = total.localFrees;
+    stats->remoteFrees = total.remoteFrees;
+    stats->slabsCreated = total.slabsCreated;
+    stats->slabsReleased = total.slabsReleased;
+    stats->liveObjects = total.liveObjects;
+    stats->reservedBytes = total.reservedBytes;
+    stats->abandonedHeaps = total.abandonedHeaps;
+}
+
+JOBSYSTEM_C_API void JobSystem_GetSchedulerStats(JobSystem* system, JobSchedulerStats* stats) {
+    if (!system || !stats) return;
+
+    SchedulerStats snapshot;
+    system->GetSchedulerStats(&snapshot);
+    stats->workerCount = snapshot.workerCount;
+    stats->minWorkers = snapshot.minWorkers;
+    stats->activeWorkers = snapshot.activeWorkers;
+    stats->parkedWorkers = snapshot.parkedWorkers;
+    stats->parkCount = snapshot.parkCount;
+    stats->wakeCount = snapshot.wakeCount;
+    stats->lastWakeQueueDepth = snapshot.lastWakeQueueDepth;
+    stats->_padding = 0;
+    stats->jobsExecuted = snapshot.jobsExecuted;
+    stats->stealAttempts = snapshot.stealAttempts;
+    stats->stealSuccesses = snapshot.stealSuccesses;
+}
+
 // ✅ 纯C++函数指针版本 - 零跨界开销
 JOBSYSTEM_C_API Job* JobSystem_ParallelForNative(
     JobSystem* system,
@@ -287,3 +452,186 @@ JOBSYSTEM_C_API Job* JobSystem_ParallelForNative(
 
     return rootJob;
 }
+
+// ====== Parallel For Range ======
+
+// 函数指针 + userData 的小型仿函数，按值拷贝到每个分割节点
+struct ParallelRangeCallbackC {
+    ParallelRangeCallback callback;
+    void* userData;
+    void operator()(uint32_t begin, uint32_t end) const { callback(begin, end, userData); }
+};
+
+struct ParallelTileCallbackC {
+    ParallelTileCallback callback;
+    void* userData;
+    void operator()(const ParallelRange3D& tile) const { callback(&tile, userData); }
+};
+
+JOBSYSTEM_C_API Job* JobSystem_ParallelForRange(
+    JobSystem* system,
+    uint32_t begin,
+    uint32_t end,
+    uint32_t grainSize,
+    ParallelRangeCallback callback,
+    void* userData
+) {
+    if (!system || !callback) {
+        return nullptr;
+    }
+
+    return parallel_for_range(system, begin, end, grainSize, ParallelRangeCallbackC{ callback, userData });
+}
+
+JOBSYSTEM_C_API Job* JobSystem_ParallelForRange2D(
+    JobSystem* system,
+    const ParallelRange3D* range,
+    uint32_t tileX,
+    uint32_t tileY,
+    ParallelTileCallback callback,
+    void* userData
+) {
+    if (!system || !range || !callback) {
+        return nullptr;
+    }
+
+    return parallel_for_range_2d(system, range->beginX, range->endX, range->beginY, range->endY,
+                                 tileX, tileY, ParallelTileCallbackC{ callback, userData });
+}
+
+JOBSYSTEM_C_API Job* JobSystem_ParallelForRange3D(
+    JobSystem* system,
+    const ParallelRange3D* range,
+    uint32_t tileX,
+    uint32_t tileY,
+    uint32_t tileZ,
+    ParallelTileCallback callback,
+    void* userData
+) {
+    if (!system || !range || !callback) {
+        return nullptr;
+    }
+
+    return parallel_for_range_3d(system, *range, tileX, tileY, tileZ,
+                                 ParallelTileCallbackC{ callback, userData });
+}
+
+// ====== Job 图 ======
+
+JOBSYSTEM_C_API JobGraph* JobGraph_Create(void) {
+    return new (std::nothrow) JobGraph();
+}
+
+JOBSYSTEM_C_API void JobGraph_Destroy(JobGraph* graph) {
+    delete graph;
+}
+
+JOBSYSTEM_C_API uint32_t JobGraph_AddNode(JobGraph* graph, JobCallback callback, void* userData) {
+    return graph ? graph->AddNode(callback, userData) : 0;
+}
+
+JOBSYSTEM_C_API void JobGraph_AddDependency(JobGraph* graph, uint32_t before, uint32_t after) {
+    if (graph) {
+        graph->AddDependency(before, after);
+    }
+}
+
+JOBSYSTEM_C_API int JobGraph_Compile(JobGraph* graph) {
+    return graph && graph->Compile() ? 1 : 0;
+}
+
+JOBSYSTEM_C_API Job* JobGraph_Launch(JobGraph* graph, JobSystem* system, Job* parent) {
+    if (!graph || !system) return nullptr;
+    return graph->Launch(*system, parent);
+}
+
+JOBSYSTEM_C_API uint64_t JobGraph_GetCriticalPathEstimate(JobGraph* graph) {
+    return graph ? graph->GetCriticalPathEstimate() : 0;
+}
+
+// ====== 多级流水线 ======
+
+JOBSYSTEM_C_API ParallelPipeline* ParallelPipeline_Create(void) {
+    return new (std::nothrow) ParallelPipeline();
+}
+
+JOBSYSTEM_C_API void ParallelPipeline_Destroy(ParallelPipeline* pipeline) {
+    delete pipeline;
+}
+
+JOBSYSTEM_C_API void ParallelPipeline_AddStage(ParallelPipeline* pipeline, JobPipelineStageKind kind,
+    JobPipelineStageCallback callback, void* userData) {
+    if (pipeline && callback) {
+        pipeline->AddStage(kind, callback, userData);
+    }
+}
+
+JOBSYSTEM_C_API Job* ParallelPipeline_Launch(ParallelPipeline* pipeline, JobSystem* system, uint32_t maxTokens, Job* parent) {
+    if (!pipeline || !system) return nullptr;
+    return pipeline->Launch(*system, maxTokens, parent);
+}
+
+// ====== 后台通道 ======
+
+JOBSYSTEM_C_API BackgroundTask* JobSystem_SubmitBackground(JobSystem* system, JobBackgroundCallback callback, void* userData) {
+    if (!system || !callback) return nullptr;
+    return system->SubmitBackground(callback, userData);
+}
+
+JOBSYSTEM_C_API int JobSystem_BackgroundShouldYield(void) {
+    return JobSystem::BackgroundShouldYield() ? 1 : 0;
+}
+
+JOBSYSTEM_C_API void JobSystem_GetBackgroundStats(JobSystem* system, JobBackgroundStats* stats) {
+    if (!system || !stats) return;
+
+    BackgroundStats internal;
+    system->GetBackgroundStats(&internal);
+    stats->queuedTasks = internal.queuedTasks;
+    stats->runningSlices = internal.runningSlices;
+    stats->completedTasks = internal.completedTasks;
+    stats->slices = internal.slices;
+    stats->preemptions = internal.preemptions;
+    stats->frameBudgetUsedMicros = internal.frameBudgetUsedMicros;
+}
+
+JOBSYSTEM_C_API int JobBackgroundTask_GetState(BackgroundTask* task) {
+    return task ? BackgroundLane::GetState(task) : JOB_BACKGROUND_CANCELLED;
+}
+
+JOBSYSTEM_C_API void JobBackgroundTask_Cancel(BackgroundTask* task) {
+    if (task) {
+        BackgroundLane::Cancel(task);
+    }
+}
+
+JOBSYSTEM_C_API void JobBackgroundTask_Release(BackgroundTask* task) {
+    if (task) {
+        BackgroundLane::Release(task);
+    }
+}
+
+// ====== 大块内存并行操作 ======
+
+JOBSYSTEM_C_API Job* JobSystem_ParallelCopy(JobSystem* system, void* dst, const void* src, size_t bytes, Job* parent) {
+    if (!system || (bytes > 0 && (!dst || !src))) return nullptr;
+    return ParallelCopy(*system, dst, src, bytes, parent);
+}
+
+JOBSYSTEM_C_API Job* JobSystem_ParallelFill(JobSystem* system, void* dst, int value, size_t bytes, Job* parent) {
+    if (!system || (bytes > 0 && !dst)) return nullptr;
+    return ParallelFill(*system, dst, static_cast<uint8_t>(value), bytes, parent);
+}
+
+JOBSYSTEM_C_API Job* JobSystem_ParallelCopyStrided(JobSystem* system, void* dst, size_t dstStride,
+    const void* src, size_t srcStride, size_t elementSize, size_t count, Job* parent) {
+    if (!system || (count > 0 && elementSize > 0 && (!dst || !src))) return nullptr;
+    return ParallelCopyStrided(*system, dst, dstStride, src, srcStride, elementSize, count, parent);
+}
+
+// ====== 健康监视 ======
+
+JOBSYSTEM_C_API void JobSystem_SetHealthCallback(JobSystem* system, JobHealthCallback callback, void* userData) {
+    if (!system) return;
+    system->SetHealthCallback(callback, userData);
+}
@@ -1,12 +1,16 @@
 #pragma once
 
 #include "JobSystemExport.h"
+#include "JobSystemConfig.h"
 #include <stdint.h>
 #include <stddef.h>
 
 // 前向声明
 typedef struct JobSystem JobSystem;
 typedef struct Job Job;
+typedef struct JobGraph JobGraph;
+typedef struct ParallelPipeline ParallelPipeline;
+typedef struct BackgroundTask BackgroundTask;
 
 // 函数指针类型定义
 typedef void (*JobCallback)(Job* job, void* data);
@@ -23,12 +27,35 @@ extern "C" {
  */
 JOBSYSTEM_C_API JobSystem* JobSystem_Create();
 
+/**
+ * 获取默认创建参数
+ * config: 输出
+ */
+JOBSYSTEM_C_API void JobSystem_GetDefaultConfig(JobSystemConfig* config);
+
+/**
+ * 按参数创建并初始化 JobSystem
+ * 工作线程按 CPU 拓扑（同 L3 -> 同 NUMA 节点 -> 其他）分配 CPU 和窃取顺序，
+ * 每个工作线程在自己线程上分配窃取队列和 Job 缓冲
+ * config: 创建参数（NULL 表示默认值）
+ * 返回: JobSystem 实例指针
+ */
+JOBSYSTEM_C_API JobSystem* JobSystem_CreateEx(const JobSystemConfig* config);
+
 /**
  * 销毁 JobSystem
+ * 先按 shutdownMode 排空（执行或丢弃）所有已提交的 Job；
+ * persistentWorkers 时工作线程留在进程级线程池中供下一次创建复用
  * system: JobSystem 实例指针
  */
 JOBSYSTEM_C_API void JobSystem_Destroy(JobSystem* system);
 
+/**
+ * 结束线程池中保留的空闲工作线程（插件 / 域卸载前调用）
+ * 返回: 1 成功；仍有 JobSystem 实例存在时返回 0
+ */
+JOBSYSTEM_C_API int JobSystem_ReleaseWorkerPool(void);
+
 /**
  * 帧开始（在每帧开始时调用）
  * system: JobSystem 实例指针
@@ -41,6 +68,34 @@ JOBSYSTEM_C_API void JobSystem_FrameStart(JobSystem* system);
  */
 JOBSYSTEM_C_API void JobSystem_FrameEnd(JobSystem* system);
 
+/**
+ * 设置帧流水线深度（同时在途的帧数，1 ~ 3，默认 1）
+ * 深度为 N 时，FrameStart 只等待 N 帧之前的帧栅栏，FrameEnd 不等待
+ * system: JobSystem 实例指针
+ * depth: 流水线深度
+ */
+JOBSYSTEM_C_API void JobSystem_SetPipelineDepth(JobSystem* system, uint32_t depth);
+
+/**
+ * 获取当前帧号（每次 FrameStart 加 1）
+ */
+JOBSYSTEM_C_API uint32_t JobSystem_GetFrameIndex(JobSystem* system);
+
+/**
+ * 获取当前帧栅栏（FrameStart 和 FrameEnd 之间有效）
+ * 本帧的 Job 以它为父 Job 创建（JobSystem_CreateChildJob），栅栏完成即本帧完成
+ * 返回: 栅栏 Job 指针，不在帧内时返回 NULL
+ */
+JOBSYSTEM_C_API Job* JobSystem_GetFrameFence(JobSystem* system);
+
+/**
+ * 获取上一帧栅栏，用于表达帧间依赖：
+ * JobSystem_AddContinuation(system, JobSystem_GetPreviousFrameFence(system), job)
+ * 若上一帧已完成，continuation 会立即运行
+ * 返回: 栅栏 Job 指针，第一帧时返回 NULL
+ */
+JOBSYSTEM_C_API Job* JobSystem_GetPreviousFrameFence(JobSystem* system);
+
 // ====== Job 操作 ======
 
 /**
@@ -76,6 +131,24 @@ JOBSYSTEM_C_API void JobSystem_RunJob(JobSystem* system, Job* job);
  */
 JOBSYSTEM_C_API void JobSystem_WaitJob(JobSystem* system, Job* job);
 
+/**
+ * 等待一组 Job 全部完成
+ * system: JobSystem 实例指针
+ * jobs: Job 指针数组
+ * count: 数组长度
+ * options: 等待策略和超时，NULL 时与 JobSystem_WaitJob 相同（主线程用配置的 mainThreadWaitPolicy）
+ * 非工作线程调用时总是阻塞等待
+ * 返回: 全部完成返回 1，超时返回 0
+ */
+JOBSYSTEM_C_API int JobSystem_WaitAll(JobSystem* system, Job* const* jobs, uint32_t count, const JobWaitOptions* options);
+
+/**
+ * 等待一组 Job 中任意一个完成
+ * 参数同 JobSystem_WaitAll
+ * 返回: 已完成 Job 的下标，超时或参数无效返回 -1
+ */
+JOBSYSTEM_C_API int JobSystem_WaitAny(JobSystem* system, Job* const* jobs, uint32_t count, const JobWaitOptions* options);
+
 /**
  * 添加 Continuation（依赖关系）
  * system: JobSystem 实例指针
@@ -84,6 +157,58 @@ JOBSYSTEM_C_API void JobSystem_WaitJob(JobSystem* system, Job* job);
  */
 JOBSYSTEM_C_API void JobSystem_AddContinuation(JobSystem* system, Job* job, Job* continuation);
 
+/**
+ * 取消 Job 及其所有子孙 Job（协作式）
+ * 尚未执行的 Job 跳过回调但仍完成计数；已在执行的回调可轮询 Job_IsCancelled 提前返回
+ * continuation 不属于子树，仍会运行
+ * system: JobSystem 实例指针
+ * job: 要取消的 Job
+ */
+JOBSYSTEM_C_API void JobSystem_CancelJob(JobSystem* system, Job* job);
+
+/**
+ * 查询 Job 是否已取消（自身或任一祖先被取消）
+ * 返回: 1 表示已取消，0 表示未取消
+ */
+JOBSYSTEM_C_API int Job_IsCancelled(Job* job);
+
+/**
+ * 标记 Job 只能在主线程执行（可调用 Unity API）
+ * 需在 RunJob 之前（或作为 continuation 被触发之前）调用
+ * 这类 Job 不会被工作线程窃取，只在主线程调用 JobSystem_WaitJob、JobSystem_FrameEnd
+ * 或 JobSystem_PumpMainThread 时执行
+ * job: Job 指针
+ */
+JOBSYSTEM_C_API void Job_SetMainThreadOnly(Job* job);
+
+/**
+ * Job 调度提示（仅在大小核混合的 CPU 上生效）
+ */
+typedef enum JobSchedulingHint {
+    JOB_HINT_NONE = 0,
+    JOB_HINT_LATENCY_CRITICAL = 1,   // 延迟敏感：优先在大核执行
+    JOB_HINT_THROUGHPUT = 2          // 吞吐：优先在小核执行，大核空闲时才接手
+} JobSchedulingHint;
+
+/**
+ * 设置 Job 的调度提示（JobSchedulingHint），需在 RunJob 之前调用
+ * 之后以它为父 Job 创建的子 Job 继承该提示
+ */
+JOBSYSTEM_C_API void Job_SetSchedulingHint(Job* job, int hint);
+
+/**
+ * 查询 CPU 是否为大小核混合（由 cpu_capacity 或最高频率判断）
+ * 返回: 1 表示混合，0 表示同构（调度提示被忽略）
+ */
+JOBSYSTEM_C_API int JobSystem_IsHeterogeneous(JobSystem* system);
+
+/**
+ * 在主线程上执行所有已就绪的主线程 Job
+ * system: JobSystem 实例指针
+ * 返回: 执行的 Job 数量（非主线程调用时返回 0）
+ */
+JOBSYSTEM_C_API int JobSystem_PumpMainThread(JobSystem* system);
+
 /**
  * 获取 Job 的用户数据
  * job: Job 指针
@@ -98,6 +223,27 @@ JOBSYSTEM_C_API void* Job_GetUserData(Job* job);
  */
 JOBSYSTEM_C_API void Job_SetUserData(Job* job, void* userData);
 
+/**
+ * 在 Job 回调中申请临时内存（当前工作线程私有的线性分配器，无锁）
+ * 回调返回后自动回收，不能保存到 Job 之外
+ * job: 当前正在执行的 Job（回调的第一个参数）
+ * alignment: 对齐字节数（2 的幂，0 按 1 处理）
+ * 返回: 内存指针，失败时返回 NULL
+ */
+JOBSYSTEM_C_API void* Job_AllocScratch(Job* job, size_t size, size_t alignment);
+
+/**
+ * 与 Job_AllocScratch 相同，供拿不到 Job 指针的回调使用（如 NativeCallback）
+ * 在 Job 之外（主线程）调用时，内存到下一次 JobSystem_FrameStart 回收
+ */
+JOBSYSTEM_C_API void* JobSystem_GetScratch(JobSystem* system, size_t size, size_t alignment);
+
+/**
+ * 申请帧级临时内存：本帧栅栏完成前一直有效，可以传给同一帧的其他 Job
+ * 每个线程、每个在途帧一块，帧槽位复用时整体回收
+ */
+JOBSYSTEM_C_API void* JobSystem_AllocFrameScratch(JobSystem* system, size_t size, size_t alignment);
+
 /**
  * 开始性能追踪会话
  * filepath: 输出文件路径（Chrome Tracing格式）
@@ -109,6 +255,23 @@ JOBSYSTEM_C_API void Profiler_BeginSession(const char* filepath);
  */
 JOBSYSTEM_C_API void Profiler_EndSession();
 
+/**
+ * 捕获 Job 图（创建、父子、continuation、执行线程、提交 / 开始 / 结束时间），写入二进制文件，
+ * 用 JobGraphAnalyzer 离线分析关键路径、总工作量、可达加速比、窃取次数和空闲间隙
+ * system: JobSystem 实例指针
+ * path: 输出文件路径（NULL 表示 "JobGraph.bin"）
+ * frameCount: 从下一次 FrameStart 起捕获的帧数，最后一帧完成后自动写出；0 表示立即开始直到 EndGraphCapture
+ * maxJobs: 记录的 Job 数上限（0 表示默认值）
+ * 返回: 1 成功，捕获已在进行中时返回 0
+ */
+JOBSYSTEM_C_API int JobSystem_BeginGraphCapture(JobSystem* system, const char* path, uint32_t frameCount, uint32_t maxJobs);
+
+/**
+ * 提前结束 Job 图捕获并写出文件（等待在途帧完成）
+ * 返回: 1 已写出，没有进行中的捕获或写入失败时返回 0
+ */
+JOBSYSTEM_C_API int JobSystem_EndGraphCapture(JobSystem* system);
+
 // ====== Parallel For ======
 
 /**
@@ -125,7 +288,7 @@ typedef void (*ParallelForCallback)(void* data, uint32_t count);
  * count: 数组元素总数
  * elementSize: 单个元素的字节大小（用于正确的指针运算）
  * callback: 处理函数回调（C# delegate）
- * threshold: 分割阈值（当元素数量大于此值时才分割，默认 256）
+ * threshold: 分割阈值（当元素数量大于此值时才分割，默认 256；0 表示自动分块）
  * 返回: 根 Job 指针，可用于等待所有任务完成
  */
 JOBSYSTEM_C_API Job* JobSystem_ParallelFor(
@@ -145,6 +308,8 @@ JOBSYSTEM_C_API Job* JobSystem_ParallelFor(
  *
  * nativeFuncPtr: 纯C++函数指针 void(*)(void* data, uint32_t count, void* userData)
  * userData: 传递给C++函数的用户数据（如PhysicsParams）
+ * threshold: 每个分块的元素数量；0 表示自动分块：按该回调的历史叶子耗时（跨帧 EMA）
+ *            选择分块大小，目标叶子耗时约 50us，工作量足够时每线程至少 4 个 Job
  */
 typedef void (*NativeCallback)(void* data, uint32_t count, void* userData);
 
@@ -158,6 +323,318 @@ JOBSYSTEM_C_API Job* JobSystem_ParallelForNative(
     uint32_t threshold
 );
 
+/**
+ * 查询自动分块的统计（threshold 为 0 的调用点）
+ * callback: ParallelForNative 的 nativeFuncPtr 或 ParallelFor 的 callback
+ * nanosPerElement: 可选，输出每元素耗时 EMA（纳秒）
+ * 返回: 最近一次选定的分块大小，未记录过该回调时返回 0
+ */
+JOBSYSTEM_C_API uint32_t JobSystem_GetAutoBatchSize(const void* callback, float* nanosPerElement);
+
+/**
+ * 内部小对象分配器统计（ParallelFor 叶子数据等，按线程 slab 分配）
+ */
+typedef struct JobSystemAllocatorStats {
+    uint64_t allocations;     // 累计分配次数
+    uint64_t localFrees;      // 累计在分配线程上释放的次数
+    uint64_t remoteFrees;     // 累计跨线程释放的次数
+    uint64_t slabsCreated;    // 累计创建的 slab 数量
+    uint64_t slabsReleased;   // 累计归还系统的 slab 数量
+    uint64_t liveObjects;     // 当前存活对象数量
+    uint64_t reservedBytes;   // 当前 slab 占用字节数
+    uint64_t abandonedHeaps;  // 线程退出后等待接管的堆数量
+} JobSystemAllocatorStats;
+
+/**
+ * 获取内部小对象分配器统计（所有分配器合计）
+ */
+JOBSYSTEM_C_API void JobSystem_GetAllocatorStats(JobSystemAllocatorStats* stats);
+
+/**
+ * 调度器统计（弹性线程数与窃取情况）
+ * 工作线程连续空闲 parkIdleMicros 后停驻（活跃数不低于 minWorkers），
+ * 本地队列积压时唤醒
+ */
+typedef struct JobSchedulerStats {
+    uint32_t workerCount;         // 工作线程总数（不含主线程）
+    uint32_t minWorkers;          // 最少活跃工作线程数
+    uint32_t activeWorkers;       // 当前活跃（未停驻）的工作线程数
+    uint32_t parkedWorkers;       // 当前停驻的工作线程数
+    uint64_t parkCount;           // 累计停驻次数
+    uint64_t wakeCount;           // 累计唤醒次数
+    uint32_t lastWakeQueueDepth;  // 最近一次唤醒时的队列长度
+    uint32_t _padding;
+    uint64_t jobsExecuted;        // 累计执行的 Job 数量
+    uint64_t stealAttempts;       // 累计窃取尝试次数
+    uint64_t stealSuccesses;      // 累计窃取成功次数
+} JobSchedulerStats;
+
+/**
+ * 获取调度器统计
+ * system: JobSystem 实例指针
+ * stats: 输出
+ */
+JOBSYSTEM_C_API void JobSystem_GetSchedulerStats(JobSystem* system, JobSchedulerStats* stats);
+
+// ====== Parallel For Range（索引区间 / 分块） ======
+
+/**
+ * 3D 索引范围，各轴均为 [begin, end)
+ */
+typedef struct ParallelRange3D {
+    uint32_t beginX, endX;
+    uint32_t beginY, endY;
+    uint32_t beginZ, endZ;
+} ParallelRange3D;
+
+/**
+ * 1D 区间回调：处理索引 [begin, end)
+ */
+typedef void (*ParallelRangeCallback)(uint32_t begin, uint32_t end, void* userData);
+
+/**
+ * 分块回调：处理一个 2D/3D 分块（2D 时 z 范围为 [0, 1)）
+ */
+typedef void (*ParallelTileCallback)(const ParallelRange3D* tile, void* userData);
+
+/**
+ * 并行处理索引区间 [begin, end)，不需要数据指针
+ * grainSize: 每个叶子的最大索引数量（0 使用默认值 256）
+ * 返回: 根 Job 指针，调用方需 RunJob + WaitJob
+ */
+JOBSYSTEM_C_API Job* JobSystem_ParallelForRange(
+    JobSystem* system,
+    uint32_t begin,
+    uint32_t end,
+    uint32_t grainSize,
+    ParallelRangeCallback callback,
+    void* userData
+);
+
+/**
+ * 按 tileX * tileY 分块并行处理 2D 范围（忽略 range 的 z 分量）
+ * tileX/tileY: 分块形状（0 使用默认值 64）
+ * 返回: 根 Job 指针，调用方需 RunJob + WaitJob
+ */
+JOBSYSTEM_C_API Job* JobSystem_ParallelForRange2D(
+    JobSystem* system,
+    const ParallelRange3D* range,
+    uint32_t tileX,
+    uint32_t tileY,
+    ParallelTileCallback callback,
+    void* userData
+);
+
+/**
+ * 按 tileX * tileY * tileZ 分块并行处理 3D 范围
+ * tileX/tileY/tileZ: 分块形状（0 使用默认值 16）
+ * 返回: 根 Job 指针，调用方需 RunJob + WaitJob
+ */
+JOBSYSTEM_C_API Job* JobSystem_ParallelForRange3D(
+    JobSystem* system,
+    const ParallelRange3D* range,
+    uint32_t tileX,
+    uint32_t tileY,
+    uint32_t tileZ,
+    ParallelTileCallback callback,
+    void* userData
+);
+
+// ====== Job 图（关键路径调度） ======
+
+/**
+ * 创建空的 Job 图：先声明节点和依赖，再反复 Launch
+ * 开启 JobSystemConfig::criticalPathScheduling 时，按历史耗时估计的剩余路径越长的节点越先执行
+ * 返回: 图指针，用 JobGraph_Destroy 释放
+ */
+JOBSYSTEM_C_API JobGraph* JobGraph_Create(void);
+
+/**
+ * 销毁 Job 图（不能有在途的 Launch）
+ */
+JOBSYSTEM_C_API void JobGraph_Destroy(JobGraph* graph);
+
+/**
+ * 添加节点
+ * callback: 节点回调（job 为本次执行的节点 Job）
+ * userData: 传给回调的用户数据
+ * 返回: 节点编号
+ */
+JOBSYSTEM_C_API uint32_t JobGraph_AddNode(JobGraph* graph, JobCallback callback, void* userData);
+
+/**
+ * 添加依赖：after 在 before 的回调返回后才开始
+ */
+JOBSYSTEM_C_API void JobGraph_AddDependency(JobGraph* graph, uint32_t before, uint32_t after);
+
+/**
+ * 编译（拓扑排序），存在环或无效依赖时返回 0
+ * Launch 时未编译会自动编译
+ */
+JOBSYSTEM_C_API int JobGraph_Compile(JobGraph* graph);
+
+/**
+ * 执行一次图
+ * parent: 可选父 Job（如帧栅栏），可为 NULL
+ * 返回: 根 Job 指针，调用方需 RunJob + WaitJob；编译失败时返回 NULL
+ */
+JOBSYSTEM_C_API Job* JobGraph_Launch(JobGraph* graph, JobSystem* system, Job* parent);
+
+/**
+ * 最近一次 Launch 估计的关键路径长度（纳秒）
+ */
+JOBSYSTEM_C_API uint64_t JobGraph_GetCriticalPathEstimate(JobGraph* graph);
+
+// ====== 多级流水线 ======
+
+/**
+ * 流水线级的类型
+ */
+typedef enum JobPipelineStageKind {
+    JOB_PIPELINE_SERIAL_IN_ORDER = 0,     // 串行，按输入顺序处理
+    JOB_PIPELINE_SERIAL_OUT_OF_ORDER = 1, // 串行，顺序不限
+    JOB_PIPELINE_PARALLEL = 2             // 并行
+} JobPipelineStageKind;
+
+/**
+ * 流水线级回调
+ * item: 上一级返回的数据项（输入级为 NULL）
+ * userData: 用户数据
+ * 返回: 交给下一级的数据项；输入级返回 NULL 表示输入结束，其他级返回 NULL 表示丢弃该数据项
+ */
+typedef void* (*JobPipelineStageCallback)(void* item, void* userData);
+
+/**
+ * 创建空的流水线：依次添加各级，再反复 Launch
+ * 返回: 流水线指针，用 ParallelPipeline_Destroy 释放
+ */
+JOBSYSTEM_C_API ParallelPipeline* ParallelPipeline_Create(void);
+
+/**
+ * 销毁流水线（不能有在途的 Launch）
+ */
+JOBSYSTEM_C_API void ParallelPipeline_Destroy(ParallelPipeline* pipeline);
+
+/**
+ * 添加一级（第一级为输入级，串行调用，kind 被忽略）
+ * kind: JobPipelineStageKind
+ */
+JOBSYSTEM_C_API void ParallelPipeline_AddStage(ParallelPipeline* pipeline, JobPipelineStageKind kind,
+    JobPipelineStageCallback callback, void* userData);
+
+/**
+ * 执行一次流水线
+ * maxTokens: 同时在途的数据项上限，0 表示线程数的 2 倍
+ * parent: 可选父 Job，可为 NULL
+ * 返回: 根 Job 指针，调用方需 RunJob + WaitJob；没有任何级时返回 NULL
+ */
+JOBSYSTEM_C_API Job* ParallelPipeline_Launch(ParallelPipeline* pipeline, JobSystem* system, uint32_t maxTokens, Job* parent);
+
+// ====== 后台通道 ======
+
+/**
+ * 后台任务回调：执行一段工作后返回
+ * 返回: 非 0 表示完成；0 表示让出，之后（可能在下一帧、另一个线程上）再次调用，进度由任务保存在 userData 中
+ */
+typedef int (*JobBackgroundCallback)(void* userData);
+
+/**
+ * 后台任务状态
+ */
+typedef enum JobBackgroundState {
+    JOB_BACKGROUND_QUEUED = 0,     // 排队或正在执行
+    JOB_BACKGROUND_DONE = 1,
+    JOB_BACKGROUND_CANCELLED = 2
+} JobBackgroundState;
+
+/**
+ * 后台通道统计
+ */
+typedef struct JobBackgroundStats {
+    uint32_t queuedTasks;           // 排队中的任务数
+    uint32_t runningSlices;         // 正在执行的时间片数
+    uint64_t completedTasks;        // 累计完成的任务数
+    uint64_t slices;                // 累计时间片数
+    uint64_t preemptions;           // 累计因帧 Job 到达而让出的次数
+    uint64_t frameBudgetUsedMicros; // 本帧已用的预算
+} JobBackgroundStats;
+
+/**
+ * 提交后台任务（跨多帧的长任务，如导航网格重建、纹理转码）
+ * 工作线程取不到帧 Job 时按时间片执行，受 JobSystemConfig 的 backgroundWorkers /
+ * backgroundBudgetMicros / backgroundSliceMicros 限制
+ * system: JobSystem 实例指针
+ * callback: 任务回调，回调内应周期性调用 JobSystem_BackgroundShouldYield
+ * userData: 传给回调的用户数据
+ * 返回: 任务句柄，不再使用时用 JobBackgroundTask_Release 释放；失败返回 NULL
+ */
+JOBSYSTEM_C_API BackgroundTask* JobSystem_SubmitBackground(JobSystem* system, JobBackgroundCallback callback, void* userData);
+
+/**
+ * 后台任务检查点：时间片或本帧预算用完、有帧 Job 到达或任务被取消时返回 1，
+ * 此时回调应保存进度并返回 0；不在后台时间片内调用时返回 0
+ */
+JOBSYSTEM_C_API int JobSystem_BackgroundShouldYield(void);
+
+/**
+ * 获取后台通道统计
+ */
+JOBSYSTEM_C_API void JobSystem_GetBackgroundStats(JobSystem* system, JobBackgroundStats* stats);
+
+/**
+ * 查询后台任务状态
+ * 返回: JobBackgroundState
+ */
+JOBSYSTEM_C_API int JobBackgroundTask_GetState(BackgroundTask* task);
+
+/**
+ * 取消后台任务：不再被调用；正在执行的时间片在下一个检查点让出
+ */
+JOBSYSTEM_C_API void JobBackgroundTask_Cancel(BackgroundTask* task);
+
+/**
+ * 释放任务句柄（任务未完成时继续执行，完成后自动回收）
+ */
+JOBSYSTEM_C_API void JobBackgroundTask_Release(BackgroundTask* task);
+
+// ====== 大块内存并行操作 ======
+
+/**
+ * 并行拷贝 bytes 字节（src 与 dst 不能重叠），按目标页边界切分给多个线程
+ * 超过 8MB 时使用 non-temporal 写入，目标数据不进入缓存
+ * parent: 可选父 Job，可为 NULL
+ * 返回: 根 Job 指针，调用方需 RunJob + WaitJob（或用 AddContinuation 接后续 Job）；失败返回 NULL
+ */
+JOBSYSTEM_C_API Job* JobSystem_ParallelCopy(JobSystem* system, void* dst, const void* src, size_t bytes, Job* parent);
+
+/**
+ * 并行把 bytes 字节填充为 value（取低 8 位），切分与写入方式同 JobSystem_ParallelCopy
+ * 返回: 根 Job 指针，调用方需 RunJob + WaitJob；失败返回 NULL
+ */
+JOBSYSTEM_C_API Job* JobSystem_ParallelFill(JobSystem* system, void* dst, int value, size_t bytes, Job* parent);
+
+/**
+ * 并行跨步拷贝 count 个 elementSize 字节的元素
+ * dstStride/srcStride: 相邻元素的字节间隔；都等于 elementSize 时等同于 JobSystem_ParallelCopy
+ * 返回: 根 Job 指针，调用方需 RunJob + WaitJob；失败返回 NULL
+ */
+JOBSYSTEM_C_API Job* JobSystem_ParallelCopyStrided(JobSystem* system, void* dst, size_t dstStride,
+    const void* src, size_t srcStride, size_t elementSize, size_t count, Job* parent);
+
+// ====== 健康监视 ======
+
+/**
+ * 注册调度健康监视回调（NULL 清除），第一次注册时启动监视线程
+ * 监视线程每 healthIntervalMicros 采样一次各线程心跳，报告：
+ *   JOB_HEALTH_LONG_JOB     单个 Job 执行超过 healthLongJobMicros（event->function / data 为该 Job 的回调和用户数据）
+ *   JOB_HEALTH_WAIT_TIMEOUT 等待超过 healthWaitTimeoutMicros（event->function 为等待的第一个 Job 的函数）
+ *   JOB_HEALTH_QUEUE_GROWTH 未完成的 Job 数连续 healthQueueGrowthSamples 次采样增长
+ *   JOB_HEALTH_STALL        有未完成的 Job，但 healthStallMicros 内没有任何 Job 执行或完成
+ * 持续时间按采样间隔计算，精度为一个间隔；同一个异常只报告一次
+ * callback: 在监视线程上调用，不能在其中调用 JobSystem_SetHealthCallback；本函数返回后旧回调不会再被调用
+ */
+JOBSYSTEM_C_API void JobSystem_SetHealthCallback(JobSystem* system, JobHealthCallback callback, void* userData);
+
 #ifdef __cplusplus
 }
 #endif
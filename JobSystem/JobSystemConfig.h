@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdint.h>
+
+// 关闭时如何处理已提交但尚未执行的 Job
+typedef enum JobSystemShutdownMode {
+    JOBSYSTEM_SHUTDOWN_DRAIN = 0,   // 全部执行完再关闭
+    JOBSYSTEM_SHUTDOWN_DISCARD = 1  // 按取消处理：跳过函数（RUN_ON_CANCEL 的清理函数仍执行），只完成计数
+} JobSystemShutdownMode;
+
+// 等待时的协助策略（WaitAll / WaitAny / WaitJob）
+typedef enum JobWaitPolicy {
+    JOB_WAIT_HELP_ANY = 0,      // 等待期间执行任意就绪 Job
+    JOB_WAIT_HELP_SUBTREE = 1,  // 只执行被等待 Job 子树中的 Job，其他 Job 转入溢出队列交给其他线程
+    JOB_WAIT_HELP_BUDGET = 2,   // 子树中的 Job 随时执行；其他 Job 只在等待开始后 budgetMicros 内、
+                                // 且有历史耗时记录（按函数抽样计时）并放得进剩余预算时执行
+    JOB_WAIT_BLOCK = 3          // 不协助，阻塞直到完成或超时（非工作线程总是使用该策略）；
+                                // 主线程阻塞时不执行主线程 Job，不能等待依赖它们的 Job
+} JobWaitPolicy;
+
+struct Job;
+
+// 健康监视事件类型
+typedef enum JobHealthEventType {
+    JOB_HEALTH_LONG_JOB = 0,        // 某线程上同一个 Job 执行超过 healthLongJobMicros
+    JOB_HEALTH_WAIT_TIMEOUT = 1,    // 某线程的一次等待超过 healthWaitTimeoutMicros
+    JOB_HEALTH_QUEUE_GROWTH = 2,    // 未完成的 Job 数连续 healthQueueGrowthSamples 次采样增长
+    JOB_HEALTH_STALL = 3            // 有未完成的 Job，但 healthStallMicros 内没有 Job 完成、也没有线程在执行 Job
+} JobHealthEventType;
+
+// 健康监视事件（在监视线程上回调）
+typedef struct JobHealthEvent {
+    int32_t type;                   // JobHealthEventType
+    int32_t threadIndex;            // 长 Job / 等待所在线程（0 为主线程），其他事件为 -1
+    void (*function)(struct Job* job, void* data); // 长 Job 的函数 / 等待的第一个 Job 的函数，其他事件为 NULL
+    void* data;                     // 长 Job 的 data（C API 创建的 Job 为 JobSystem_CreateJob 的 callback / userData）
+    uint64_t durationMicros;        // 已持续的时间（由采样得出，精度为采样间隔）
+    uint64_t pendingJobs;           // 已提交但未完成的 Job 数
+} JobHealthEvent;
+
+typedef void (*JobHealthCallback)(const JobHealthEvent* event, void* userData);
+
+// 等待参数
+typedef struct JobWaitOptions {
+    int32_t policy;         // JobWaitPolicy
+    uint32_t timeoutMicros; // 0 表示不限时；协助等待只在两次执行之间检查超时
+    uint32_t budgetMicros;  // JOB_WAIT_HELP_BUDGET 的预算
+    uint32_t _padding;
+} JobWaitOptions;
+
+// JobSystem 创建参数（C 兼容，供 JobSystem_CreateEx 使用）
+// 先用 JobSystem_GetDefaultConfig 填充默认值，再修改需要的字段
+typedef struct JobSystemConfig {
+    uint32_t numThreads;    // 参与执行 Job 的线程数（含主线程），0 表示 hardware_concurrency
+    int32_t pinThreads;     // 非 0：把工作线程绑定到按拓扑分配的 CPU（主线程不绑定）
+    int32_t pinCoreClasses; // 非 0：pinThreads 为 0 且有大小核时，把工作线程限制在所属类别（大核 / 小核）上；
+                            // 为 0 时不改动未绑定线程的亲和性
+    int32_t hugePages;      // 非 0：Job 缓冲尝试使用大页（Linux 透明大页）
+    uint32_t minWorkers;    // 最少保持活跃的工作线程数（不含主线程），超出部分空闲时停驻；
+                            // 大于等于工作线程总数时不停驻（固定线程池）
+    uint32_t parkIdleMicros;// 工作线程连续空闲超过该时间（微秒）后停驻
+    int32_t persistentWorkers; // 非 0：销毁后工作线程留在进程级线程池中（连同队列和 Job 缓冲），
+                               // 下一次创建直接接管，不再重新创建线程
+    int32_t deferLogOpen;   // 非 0：日志文件推迟到第一次写日志时才打开
+    int32_t shutdownMode;   // JobSystemShutdownMode
+    int32_t criticalPathScheduling; // 非 0：带优先级的 Job（JobGraph 节点）进入共享优先队列，
+                                    // 各线程先取剩余路径最长的就绪 Job，再取自己的队列 / 窃取
+    int32_t mainThreadWaitPolicy;   // 主线程 WaitJob（含 FrameStart 等待在途帧）使用的 JobWaitPolicy
+    uint32_t backgroundWorkers;     // 后台通道：同时执行时间片的工作线程数上限，0 表示不限
+    uint32_t backgroundBudgetMicros;// 后台通道：每帧（FrameStart 之间）所有线程合计的执行时间上限，0 表示不限
+    uint32_t backgroundSliceMicros; // 后台通道：单个时间片的长度，任务在检查点发现超时后让出
+    uint32_t healthIntervalMicros;  // 健康监视：采样间隔，0 表示不监视；注册回调后才启动监视线程
+    uint32_t healthLongJobMicros;   // 健康监视：单个 Job 执行超过该时间时报告，0 表示不检查
+    uint32_t healthWaitTimeoutMicros; // 健康监视：一次等待超过该时间时报告，0 表示不检查
+    uint32_t healthStallMicros;     // 健康监视：有未完成的 Job 但超过该时间没有 Job 完成（也没有 Job 在执行）时报告，0 表示不检查
+    uint32_t healthQueueGrowthSamples; // 健康监视：未完成的 Job 数连续增长该次数采样时报告，0 表示不检查
+} JobSystemConfig;
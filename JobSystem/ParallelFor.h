@@ -49,6 +49,12 @@ void ParallelForJob(Job* job, void* jobData) {
 
     auto* pfData = static_cast<ParallelForData<T, Func, Splitter>*>(jobData);
 
+    // 已取消：不再执行和分割，只释放数据
+    if (JobSystem::IsCancelled(job)) {
+        delete pfData;
+        return;
+    }
+
     snprintf(logBuf, sizeof(logBuf),
              "[ParallelForJob] ENTRY - job=%p, jobData=%p, data=%p, count=%u, dataSize=%u\n",
              (void*)job, jobData, (void*)pfData->data, pfData->count, pfData->dataSize);
@@ -117,6 +123,7 @@ void ParallelForJob(Job* job, void* jobData) {
 
     Job* leftJob = pfData->jobSystem->CreateJob(job, ParallelForJob<T, Func, Splitter>);
     leftJob->data = leftData;
+    leftJob->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
     pfData->jobSystem->RunJob(leftJob);
 
     // 创建右半部分的作业
@@ -138,6 +145,7 @@ void ParallelForJob(Job* job, void* jobData) {
 
     Job* rightJob = pfData->jobSystem->CreateJob(job, ParallelForJob<T, Func, Splitter>);
     rightJob->data = rightData;
+    rightJob->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
     pfData->jobSystem->RunJob(rightJob);
 
     snprintf(logBuf, sizeof(logBuf),
@@ -169,6 +177,7 @@ Job* parallel_for(JobSystem* jobSystem, T* data, uint32_t count, uint32_t elemen
     // 创建并运行第一个作业
     Job* firstJob = jobSystem->CreateJob(rootJob, ParallelForJob<T, Func, Splitter>);
     firstJob->data = pfData;
+    firstJob->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
     jobSystem->RunJob(firstJob);
 
     return rootJob;
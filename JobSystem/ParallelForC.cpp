@@ -1,7 +1,96 @@
 #include "ParallelForC.h"
 #include <algorithm>
+#include <chrono>
 #include <vector>
 
+// ====== 自动分块参数 ======
+static constexpr uint32_t TUNING_TABLE_SIZE = 64;          // 调用点统计表大小（2 的幂）
+static constexpr double AUTO_TARGET_LEAF_NANOS = 50000.0;  // 目标叶子耗时 50us
+static constexpr uint32_t AUTO_MIN_JOBS_PER_THREAD = 4;    // 工作量足够时每线程至少 4 个 Job
+static constexpr uint32_t AUTO_MAX_JOBS = 1024;            // 单次提交的叶子上限（远低于 Job 环形缓冲容量）
+static constexpr uint32_t AUTO_FIRST_BATCH = 256;          // 无统计数据时的分块大小
+static constexpr float AUTO_EMA_WEIGHT = 0.25f;
+
+static ParallelForTuning g_tuningTable[TUNING_TABLE_SIZE];
+
+static inline uint32_t TuningSlot(const void* key) {
+    uint64_t h = reinterpret_cast<uintptr_t>(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return static_cast<uint32_t>(h) & (TUNING_TABLE_SIZE - 1);
+}
+
+ParallelForTuning* parallel_for_find_tuning(const void* key) {
+    if (!key) return nullptr;
+
+    // 线性探测；记录只登记不删除，CAS 保证并发登记同一个 key 时只占一个槽
+    const uint32_t start = TuningSlot(key);
+    for (uint32_t i = 0; i < TUNING_TABLE_SIZE; i++) {
+        ParallelForTuning& entry = g_tuningTable[(start + i) & (TUNING_TABLE_SIZE - 1)];
+        const void* current = entry.key.load(std::memory_order_acquire);
+        if (current == key) return &entry;
+        if (current == nullptr) {
+            if (entry.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                return &entry;
+            }
+            if (current == key) return &entry;
+        }
+    }
+    return nullptr;
+}
+
+const ParallelForTuning* parallel_for_peek_tuning(const void* key) {
+    if (!key) return nullptr;
+
+    const uint32_t start = TuningSlot(key);
+    for (uint32_t i = 0; i < TUNING_TABLE_SIZE; i++) {
+        const ParallelForTuning& entry = g_tuningTable[(start + i) & (TUNING_TABLE_SIZE - 1)];
+        const void* current = entry.key.load(std::memory_order_acquire);
+        if (current == key) return &entry;
+        if (current == nullptr) return nullptr;
+    }
+    return nullptr;
+}
+
+uint32_t parallel_for_auto_batch(ParallelForTuning* tuning, uint32_t count, int threadCount) {
+    if (count == 0) return 1;
+
+    // 合并上次提交以来的叶子样本（多个线程同时提交同一调用点时只有一个能拿到样本，足够用于估计）
+    const uint64_t nanos = tuning->sampleNanos.exchange(0, std::memory_order_relaxed);
+    const uint64_t elements = tuning->sampleElements.exchange(0, std::memory_order_relaxed);
+    float perElement = tuning->nanosPerElement.load(std::memory_order_relaxed);
+    if (elements > 0) {
+        const float sample = static_cast<float>(static_cast<double>(nanos) / static_cast<double>(elements));
+        perElement = perElement > 0.0f ? perElement + AUTO_EMA_WEIGHT * (sample - perElement) : sample;
+        if (perElement <= 0.0f) perElement = 1e-3f;
+        tuning->nanosPerElement.store(perElement, std::memory_order_relaxed);
+    }
+
+    uint32_t batch;
+    if (perElement <= 0.0f) {
+        batch = AUTO_FIRST_BATCH;
+    } else if (perElement * static_cast<double>(count) <= AUTO_TARGET_LEAF_NANOS) {
+        // 总工作量不到一个叶子：不分割
+        batch = count;
+    } else {
+        const double target = AUTO_TARGET_LEAF_NANOS / perElement;
+        batch = target >= count ? count : std::max(1u, static_cast<uint32_t>(target));
+
+        // 保证每个线程至少分到 AUTO_MIN_JOBS_PER_THREAD 个 Job，便于负载均衡
+        const uint32_t threads = static_cast<uint32_t>(std::max(1, threadCount));
+        const uint32_t balanced = std::max(1u, count / (threads * AUTO_MIN_JOBS_PER_THREAD));
+        batch = std::min(batch, balanced);
+    }
+
+    // 限制单次提交的叶子数量
+    const uint32_t minBatch = (count + AUTO_MAX_JOBS - 1) / AUTO_MAX_JOBS;
+    batch = std::max(batch, minBatch);
+
+    tuning->batchSize.store(batch, std::memory_order_relaxed);
+    return batch;
+}
+
 // 空的 C 函数，用于 rootJob
 static void EmptyJobFunction(Job*, void*) {
     // 什么都不做，只用于等待子 jobs
@@ -13,17 +102,71 @@ struct WorkRange {
     uint32_t count;
 };
 
+// 执行回调；自动分块时顺带记录耗时样本
+static inline void RunLeafCallback(ParallelForCCallback callback, void* data, uint32_t count,
+                                   void* userData, ParallelForTuning* tuning) {
+    if (!tuning) {
+        callback(data, count, userData);
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    callback(data, count, userData);
+    const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    tuning->sampleNanos.fetch_add(static_cast<uint64_t>(nanos), std::memory_order_relaxed);
+    tuning->sampleElements.fetch_add(count, std::memory_order_relaxed);
+}
+
 // 叶子节点 Job：直接执行回调，无需分割
 void ParallelForLeafJobC(Job* job, void* jobData) {
     auto* pfData = static_cast<ParallelForDataC*>(jobData);
 
-    // 直接调用 C 函数指针
-    pfData->callback(pfData->data, pfData->count, pfData->userData);
+    // 直接调用 C 函数指针（已取消时跳过回调，仍归还数据）
+    if (!JobSystem::IsCancelled(job)) {
+        RunLeafCallback(pfData->callback, pfData->data, pfData->count, pfData->userData, pfData->tuning);
+    }
 
     // 归还到对象池
     ParallelForDataCPool::GetInstance().Free(pfData);
 }
 
+// 分块叶子 Job：以索引区间调用回调
+static void ParallelChunkLeafJobC(Job* job, void* jobData) {
+    auto* chunk = static_cast<ParallelChunkDataC*>(jobData);
+    if (!JobSystem::IsCancelled(job)) {
+        chunk->callback(chunk->begin, chunk->end, chunk->chunkIndex, chunk->userData);
+    }
+    ParallelChunkDataCPool::GetInstance().Free(chunk);
+}
+
+uint32_t parallel_for_chunks_c(
+    JobSystem* jobSystem,
+    Job* parent,
+    uint32_t count,
+    uint32_t batchSize,
+    ParallelChunkCCallback callback,
+    void* userData
+) {
+    if (batchSize == 0) batchSize = 1;
+    const uint32_t chunkCount = parallel_chunk_count_c(count, batchSize);
+
+    for (uint32_t i = 0; i < chunkCount; i++) {
+        auto* chunk = ParallelChunkDataCPool::GetInstance().Allocate();
+        chunk->callback = callback;
+        chunk->userData = userData;
+        chunk->begin = i * batchSize;
+        chunk->end = std::min(count, chunk->begin + batchSize);
+        chunk->chunkIndex = i;
+
+        Job* leafJob = jobSystem->CreateJob(parent, ParallelChunkLeafJobC);
+        leafJob->data = chunk;
+        leafJob->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
+        jobSystem->RunJob(leafJob);
+    }
+
+    return chunkCount;
+}
 
 Job* parallel_for_c(
     JobSystem* jobSystem,
@@ -32,7 +175,8 @@ Job* parallel_for_c(
     uint32_t elementSize,
     ParallelForCCallback callback,
     void* userData,
-    CountSplitter& splitter
+    CountSplitter& splitter,
+    const void* tuningKey
 ) {
     // 创建根 job（使用 C 函数，不用 lambda）
     Job* rootJob = jobSystem->CreateJob(EmptyJobFunction);
@@ -40,10 +184,18 @@ Job* parallel_for_c(
     // ✅ 动态调整 batch size：避免创建过多 Job
     uint32_t batchSize = splitter.threshold;
 
+    // threshold 为 0：按调用点的历史叶子耗时自动选择
+    ParallelForTuning* tuning = nullptr;
+    if (batchSize == 0) {
+        tuning = parallel_for_find_tuning(tuningKey ? tuningKey : reinterpret_cast<const void*>(callback));
+        batchSize = tuning ? parallel_for_auto_batch(tuning, count, jobSystem->GetThreadCount())
+                           : CountSplitter().threshold;
+    }
+
     // 如果数据量很小，直接同步执行（避免 Job 创建开销）
     if (count <= batchSize) {
         char* byteData = (char*)data;
-        callback(byteData, count, userData);
+        RunLeafCallback(callback, byteData, count, userData, tuning);
         jobSystem->RunJob(rootJob);  // 立即完成 rootJob
         return rootJob;
     }
@@ -70,10 +222,12 @@ Job* parallel_for_c(
         pfData->userData = userData;
         pfData->splitter = splitter;
         pfData->parentJob = rootJob;
+        pfData->tuning = tuning;
 
         // 创建并运行叶子 Job
         Job* leafJob = jobSystem->CreateJob(rootJob, ParallelForLeafJobC);
         leafJob->data = pfData;
+        leafJob->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
         jobSystem->RunJob(leafJob);
     }
 
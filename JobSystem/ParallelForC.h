@@ -1,8 +1,10 @@
 #pragma once
 #include "JobSystem.h"
+#include "SlabAllocator.h"
 #include <cstdint>
 #include <vector>
 #include <mutex>
+#include <atomic>
 
 // C-style parallel_for without std::function or lambda
 // 专门为 C API 设计，避免 std::function 问题
@@ -10,6 +12,26 @@
 // C 风格回调类型
 typedef void (*ParallelForCCallback)(void* data, uint32_t count, void* userData);
 
+// ====== 自动分块（threshold 为 0） ======
+// 每个调用点一条统计记录：叶子 Job 累加耗时和元素数，下一次提交时折算为
+// 每元素耗时（跨帧 EMA），再按目标叶子耗时和每线程最少 Job 数推算分块大小
+struct ParallelForTuning {
+    std::atomic<const void*> key;              // 调用点标识（回调函数指针），nullptr 表示空槽
+    std::atomic<uint64_t> sampleNanos;         // 上次提交以来叶子耗时总和
+    std::atomic<uint64_t> sampleElements;      // 上次提交以来叶子处理的元素总数
+    std::atomic<float> nanosPerElement;        // 每元素耗时 EMA，0 表示尚无数据
+    std::atomic<uint32_t> batchSize;           // 最近一次选定的分块大小
+};
+
+// 查找或登记调用点的统计记录（表满时返回 nullptr，退回默认分块）
+ParallelForTuning* parallel_for_find_tuning(const void* key);
+
+// 只查找，不登记
+const ParallelForTuning* parallel_for_peek_tuning(const void* key);
+
+// 合并上次提交以来的叶子耗时，并为 count 个元素选择分块大小
+uint32_t parallel_for_auto_batch(ParallelForTuning* tuning, uint32_t count, int threadCount);
+
 // 分割策略
 struct CountSplitter {
     uint32_t threshold;
@@ -27,57 +49,51 @@ struct ParallelForDataC {
     void* userData;  // 用户数据（wrapper）
     CountSplitter splitter;  // ✅ 按值存储，避免悬空指针
     Job* parentJob;
+    ParallelForTuning* tuning;  // 自动分块时记录叶子耗时，否则为 nullptr
 };
 
-// ParallelForDataC 线程局部对象池（完全无锁，零竞争）
-class ParallelForDataCPool {
-private:
-    // 每个线程独立的对象池
-    std::vector<ParallelForDataC*> pool;
-
-    // 禁止拷贝
-    ParallelForDataCPool(const ParallelForDataCPool&) = delete;
-    ParallelForDataCPool& operator=(const ParallelForDataCPool&) = delete;
-
-public:
-    ParallelForDataCPool() = default;
-
-    // 从池中分配一个对象（无锁，线程安全）
-    ParallelForDataC* Allocate() {
-        if (!pool.empty()) {
-            ParallelForDataC* data = pool.back();
-            pool.pop_back();
-            return data;
-        }
-        // 池为空，创建新对象
-        return new ParallelForDataC();
-    }
-
-    // 归还对象到池中（无锁，线程安全）
-    void Free(ParallelForDataC* data) {
-        if (!data) return;
-        pool.push_back(data);
-    }
-
-    // 清理池中所有对象（析构时调用）
-    ~ParallelForDataCPool() {
-        for (auto* data : pool) {
-            delete data;
-        }
-        pool.clear();
-    }
-
-    // 获取线程局部单例（每个线程独立的池）
-    static ParallelForDataCPool& GetInstance() {
-        thread_local ParallelForDataCPool instance;
-        return instance;
-    }
-};
+// ParallelForDataC 对象池：每线程 slab 分配，工作线程归还的对象经远程释放栈回到提交线程
+typedef SlabObjectPool<ParallelForDataC> ParallelForDataCPool;
 
 // ParallelFor 作业函数（C 风格）
 void ParallelForJobC(Job* job, void* jobData);
 
+// 按索引区间分块的回调：[begin, end) 为元素索引，chunkIndex 为分块序号
+typedef void (*ParallelChunkCCallback)(uint32_t begin, uint32_t end, uint32_t chunkIndex, void* userData);
+
+// 分块叶子 Job 的数据
+struct ParallelChunkDataC {
+    ParallelChunkCCallback callback;
+    void* userData;
+    uint32_t begin;
+    uint32_t end;
+    uint32_t chunkIndex;
+};
+
+typedef SlabObjectPool<ParallelChunkDataC> ParallelChunkDataCPool;
+
+// 计算 count 个元素按 batchSize 分块后的块数（count == 0 时也至少 1 块）
+inline uint32_t parallel_chunk_count_c(uint32_t count, uint32_t batchSize) {
+    if (batchSize == 0) batchSize = 1;
+    uint32_t chunks = (count + batchSize - 1) / batchSize;
+    return chunks > 0 ? chunks : 1;
+}
+
+// 将 [0, count) 按 batchSize 分块，每块创建一个 parent 的子 Job 并立即运行
+// 分块 i 的范围固定为 [i * batchSize, min((i + 1) * batchSize, count))，
+// 调用方可以据此为每块预留互不重叠的输出区域（无锁合并）
+// 返回: 分块数量
+uint32_t parallel_for_chunks_c(
+    JobSystem* jobSystem,
+    Job* parent,
+    uint32_t count,
+    uint32_t batchSize,
+    ParallelChunkCCallback callback,
+    void* userData
+);
+
 // parallel_for 主函数（C 风格）
+// splitter.threshold 为 0 时自动分块，统计记录按 tuningKey 区分（nullptr 时使用 callback）
 Job* parallel_for_c(
     JobSystem* jobSystem,
     void* data,
@@ -85,5 +101,6 @@ Job* parallel_for_c(
     uint32_t elementSize,
     ParallelForCCallback callback,
     void* userData,
-    CountSplitter& splitter
+    CountSplitter& splitter,
+    const void* tuningKey = nullptr
 );
@@ -0,0 +1,307 @@
+#include "ParallelMemory.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARALLEL_MEMORY_SSE2
+#include <emmintrin.h>
+#endif
+
+// ====== 单线程内核 ======
+
+#ifdef PARALLEL_MEMORY_SSE2
+// 目标先按 16 字节对齐，主体每次 64 字节（一个缓存行）non-temporal 写入，首尾不足部分走普通写
+static void StreamCopy(uint8_t* dst, const uint8_t* src, size_t bytes)
+{
+	size_t head = (16 - (reinterpret_cast<uintptr_t>(dst) & 15)) & 15;
+	head = std::min(head, bytes);
+	memcpy(dst, src, head);
+	dst += head;
+	src += head;
+	bytes -= head;
+
+	for (; bytes >= 64; dst += 64, src += 64, bytes -= 64) {
+		const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+		const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+		const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+		const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+		_mm_stream_si128(reinterpret_cast<__m128i*>(dst), a);
+		_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), b);
+		_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), c);
+		_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), d);
+	}
+	for (; bytes >= 16; dst += 16, src += 16, bytes -= 16) {
+		_mm_stream_si128(reinterpret_cast<__m128i*>(dst), _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+	}
+	memcpy(dst, src, bytes);
+}
+
+static void StreamFill(uint8_t* dst, uint8_t value, size_t bytes)
+{
+	size_t head = (16 - (reinterpret_cast<uintptr_t>(dst) & 15)) & 15;
+	head = std::min(head, bytes);
+	memset(dst, value, head);
+	dst += head;
+	bytes -= head;
+
+	const __m128i v = _mm_set1_epi8(static_cast<char>(value));
+	for (; bytes >= 64; dst += 64, bytes -= 64) {
+		_mm_stream_si128(reinterpret_cast<__m128i*>(dst), v);
+		_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), v);
+		_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), v);
+		_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), v);
+	}
+	for (; bytes >= 16; dst += 16, bytes -= 16) {
+		_mm_stream_si128(reinterpret_cast<__m128i*>(dst), v);
+	}
+	memset(dst, value, bytes);
+}
+#endif
+
+// 常见元素大小用定长 memcpy，编译器展开为单条 load / store
+template<size_t Size>
+static void CopyElements(uint8_t* dst, size_t dstStride, const uint8_t* src, size_t srcStride, size_t count)
+{
+	for (size_t i = 0; i < count; i++, dst += dstStride, src += srcStride) {
+		memcpy(dst, src, Size);
+	}
+}
+
+static void CopyStrided(uint8_t* dst, size_t dstStride, const uint8_t* src, size_t srcStride, size_t elementSize, size_t count)
+{
+	switch (elementSize) {
+	case 4: CopyElements<4>(dst, dstStride, src, srcStride, count); return;
+	case 8: CopyElements<8>(dst, dstStride, src, srcStride, count); return;
+	case 12: CopyElements<12>(dst, dstStride, src, srcStride, count); return;
+	case 16: CopyElements<16>(dst, dstStride, src, srcStride, count); return;
+	default: break;
+	}
+	for (size_t i = 0; i < count; i++, dst += dstStride, src += srcStride) {
+		memcpy(dst, src, elementSize);
+	}
+}
+
+// ====== 单次操作 ======
+
+enum MemoryOpKind {
+	MEMORY_OP_COPY,
+	MEMORY_OP_FILL,
+	MEMORY_OP_COPY_STRIDED,
+};
+
+struct MemoryOp;
+
+// 一个分块：拷贝 / 填充为字节偏移，跨步拷贝为元素下标，都是 [begin, end)
+struct MemoryChunk {
+	MemoryOp* op;
+	size_t begin;
+	size_t end;
+};
+
+// 一次操作的参数与分块，由最后一个结束的分块释放
+// 最后一个分块之后没有别的工作，不再为释放单独调度一个 continuation
+struct MemoryOp {
+	JobSystem* jobSystem;
+	MemoryOpKind kind;
+	uint8_t* dst;
+	const uint8_t* src;
+	size_t dstStride;
+	size_t srcStride;
+	size_t elementSize;
+	uint8_t value;
+	bool streaming;
+	std::vector<MemoryChunk> chunks;
+	std::atomic<size_t> pendingChunks;
+
+	void Execute(const MemoryChunk& chunk) const;
+	void Finish(Job* job, const MemoryChunk& chunk);
+
+	static void RootJob(Job* job, void* data);
+	static void ChunkJob(Job* job, void* data);
+};
+
+void MemoryOp::Execute(const MemoryChunk& chunk) const
+{
+	const size_t size = chunk.end - chunk.begin;
+	switch (kind) {
+	case MEMORY_OP_COPY:
+#ifdef PARALLEL_MEMORY_SSE2
+		if (streaming) {
+			StreamCopy(dst + chunk.begin, src + chunk.begin, size);
+			break;
+		}
+#endif
+		memcpy(dst + chunk.begin, src + chunk.begin, size);
+		break;
+	case MEMORY_OP_FILL:
+#ifdef PARALLEL_MEMORY_SSE2
+		if (streaming) {
+			StreamFill(dst + chunk.begin, value, size);
+			break;
+		}
+#endif
+		memset(dst + chunk.begin, value, size);
+		break;
+	case MEMORY_OP_COPY_STRIDED:
+		CopyStrided(dst + chunk.begin * dstStride, dstStride, src + chunk.begin * srcStride, srcStride, elementSize, size);
+		break;
+	}
+
+#ifdef PARALLEL_MEMORY_SSE2
+	// non-temporal 写入是弱序的，Job 结束前必须 fence，保证等待方可见
+	if (streaming) {
+		_mm_sfence();
+	}
+#endif
+}
+
+void MemoryOp::Finish(Job* job, const MemoryChunk& chunk)
+{
+	// 取消后分块 Job 仍被调用（RUN_ON_CANCEL），只跳过内存操作，保证计数归零
+	if (!JobSystem::IsCancelled(job)) {
+		Execute(chunk);
+	}
+	if (pendingChunks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		delete this;
+	}
+}
+
+void MemoryOp::RootJob(Job* job, void* data)
+{
+	MemoryOp* op = static_cast<MemoryOp*>(data);
+	if (op->chunks.empty() || JobSystem::IsCancelled(job)) {
+		delete op;
+		return;
+	}
+
+	// 其余分块交给其他线程，根 Job 自己处理第一个分块
+	op->pendingChunks.store(op->chunks.size(), std::memory_order_relaxed);
+	for (size_t i = 1; i < op->chunks.size(); i++) {
+		Job* child = op->jobSystem->CreateJob(job, ChunkJob);
+		child->data = &op->chunks[i];
+		child->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
+		op->jobSystem->RunJob(child);
+	}
+	op->Finish(job, op->chunks[0]);
+}
+
+void MemoryOp::ChunkJob(Job* job, void* data)
+{
+	MemoryChunk* chunk = static_cast<MemoryChunk*>(data);
+	chunk->op->Finish(job, *chunk);
+}
+
+// ====== 分块 ======
+
+static size_t MaxChunks(const JobSystem& jobSystem)
+{
+	return static_cast<size_t>(std::max(jobSystem.GetThreadCount(), 1)) * PARALLEL_MEMORY_CHUNKS_PER_THREAD;
+}
+
+// 按目标地址的页边界切分 [0, bytes)：第一个分块延伸到页边界，之后每块都是整页
+static void SplitPages(MemoryOp* op, size_t bytes, size_t maxChunks)
+{
+	const size_t pageMask = PARALLEL_MEMORY_PAGE_SIZE - 1;
+	size_t chunkCount = (bytes + PARALLEL_MEMORY_MIN_CHUNK - 1) / PARALLEL_MEMORY_MIN_CHUNK;
+	chunkCount = std::max<size_t>(std::min(chunkCount, maxChunks), 1);
+	const size_t chunkSize = ((bytes + chunkCount - 1) / chunkCount + pageMask) & ~pageMask;
+	const size_t head = (PARALLEL_MEMORY_PAGE_SIZE - (reinterpret_cast<uintptr_t>(op->dst) & pageMask)) & pageMask;
+
+	size_t begin = 0;
+	while (begin < bytes) {
+		size_t end = begin == 0 ? head + chunkSize : begin + chunkSize;
+		end = std::min(end, bytes);
+		MemoryChunk chunk = { op, begin, end };
+		op->chunks.push_back(chunk);
+		begin = end;
+	}
+}
+
+static size_t Gcd(size_t a, size_t b)
+{
+	while (b != 0) {
+		const size_t t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+// 按元素切分 [0, count)：每块的元素数向上取整到使目标跨度为整页的倍数（目标按页对齐时分块不共享页）
+static void SplitElements(MemoryOp* op, size_t count, size_t maxChunks)
+{
+	const size_t footprint = std::max(std::max(op->dstStride, op->srcStride), op->elementSize);
+	const size_t unit = PARALLEL_MEMORY_PAGE_SIZE / Gcd(PARALLEL_MEMORY_PAGE_SIZE, op->dstStride);
+
+	size_t perChunk = std::max<size_t>(PARALLEL_MEMORY_MIN_CHUNK / std::max<size_t>(footprint, 1), 1);
+	perChunk = std::max(perChunk, (count + maxChunks - 1) / maxChunks);
+	perChunk = (perChunk + unit - 1) / unit * unit;
+
+	for (size_t begin = 0; begin < count; begin += perChunk) {
+		MemoryChunk chunk = { op, begin, std::min(begin + perChunk, count) };
+		op->chunks.push_back(chunk);
+	}
+}
+
+static MemoryOp* CreateOp(JobSystem& jobSystem, MemoryOpKind kind, void* dst, const void* src)
+{
+	MemoryOp* op = new MemoryOp();
+	op->jobSystem = &jobSystem;
+	op->kind = kind;
+	op->dst = static_cast<uint8_t*>(dst);
+	op->src = static_cast<const uint8_t*>(src);
+	op->dstStride = 0;
+	op->srcStride = 0;
+	op->elementSize = 0;
+	op->value = 0;
+	op->streaming = false;
+	return op;
+}
+
+static Job* LaunchOp(JobSystem& jobSystem, MemoryOp* op, Job* parent)
+{
+	Job* root = parent ? jobSystem.CreateJob(parent, MemoryOp::RootJob) : jobSystem.CreateJob(MemoryOp::RootJob);
+	root->data = op;
+	root->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
+	return root;
+}
+
+// ====== 对外接口 ======
+
+Job* ParallelCopy(JobSystem& jobSystem, void* dst, const void* src, size_t bytes, Job* parent)
+{
+	MemoryOp* op = CreateOp(jobSystem, MEMORY_OP_COPY, dst, src);
+	op->streaming = bytes >= PARALLEL_MEMORY_STREAMING_THRESHOLD;
+	SplitPages(op, bytes, MaxChunks(jobSystem));
+	return LaunchOp(jobSystem, op, parent);
+}
+
+Job* ParallelFill(JobSystem& jobSystem, void* dst, uint8_t value, size_t bytes, Job* parent)
+{
+	MemoryOp* op = CreateOp(jobSystem, MEMORY_OP_FILL, dst, nullptr);
+	op->value = value;
+	op->streaming = bytes >= PARALLEL_MEMORY_STREAMING_THRESHOLD;
+	SplitPages(op, bytes, MaxChunks(jobSystem));
+	return LaunchOp(jobSystem, op, parent);
+}
+
+Job* ParallelCopyStrided(JobSystem& jobSystem, void* dst, size_t dstStride, const void* src, size_t srcStride,
+	size_t elementSize, size_t count, Job* parent)
+{
+	if (dstStride == elementSize && srcStride == elementSize) {
+		return ParallelCopy(jobSystem, dst, src, elementSize * count, parent);
+	}
+
+	// 跨步写入每个元素只占缓存行的一部分，non-temporal 写入会退化为部分行写，所以总是走普通写
+	MemoryOp* op = CreateOp(jobSystem, MEMORY_OP_COPY_STRIDED, dst, src);
+	op->dstStride = dstStride;
+	op->srcStride = srcStride;
+	op->elementSize = elementSize;
+	if (elementSize > 0) {
+		SplitElements(op, count, MaxChunks(jobSystem));
+	}
+	return LaunchOp(jobSystem, op, parent);
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Job.h"
+
+class JobSystem;
+
+// ====== 大块内存并行拷贝 / 填充 ======
+// 按目标地址的页边界（4KB）切分给多个线程，分块不跨页，各线程写的页互不重叠
+// 总字节数不小于 PARALLEL_MEMORY_STREAMING_THRESHOLD 时用 non-temporal 写入（SSE2），
+// 目标数据不经过缓存，避免把其他线程的工作集挤出 LLC；其他平台退化为 memcpy / memset
+// 返回根 Job（未运行），调用方 RunJob + WaitJob，或作为其他 Job 的前驱添加 continuation；
+// Job 完成前不能读写目标区间，也不能修改源区间
+// parent 非空时根 Job 作为它的子 Job；字节数为 0 时根 Job 为空操作
+
+static constexpr size_t PARALLEL_MEMORY_PAGE_SIZE = 4096;
+// 每个分块的最小字节数：更小的分块调度开销超过带宽收益
+static constexpr size_t PARALLEL_MEMORY_MIN_CHUNK = 256 * 1024;
+// 每个线程最多分到的块数（负载均衡与 Job 数量的折中）
+static constexpr size_t PARALLEL_MEMORY_CHUNKS_PER_THREAD = 4;
+// 超过该大小（约为常见 LLC 容量）时使用 non-temporal 写入
+static constexpr size_t PARALLEL_MEMORY_STREAMING_THRESHOLD = 8 * 1024 * 1024;
+
+Job* ParallelCopy(JobSystem& jobSystem, void* dst, const void* src, size_t bytes, Job* parent = nullptr);
+Job* ParallelFill(JobSystem& jobSystem, void* dst, uint8_t value, size_t bytes, Job* parent = nullptr);
+
+// 跨步拷贝：count 个 elementSize 字节的元素，源 / 目标相邻元素间隔 srcStride / dstStride 字节
+// （用于 AoS 中抽取字段、交错缓冲拆分等）；两个 stride 都等于 elementSize 时等同于 ParallelCopy
+Job* ParallelCopyStrided(JobSystem& jobSystem, void* dst, size_t dstStride, const void* src, size_t srcStride,
+	size_t elementSize, size_t count, Job* parent = nullptr);
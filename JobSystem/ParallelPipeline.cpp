@@ -0,0 +1,288 @@
+#include "ParallelPipeline.h"
+#include "JobSystem.h"
+#include <deque>
+#include <memory>
+#include <mutex>
+
+// ====== 单次执行 ======
+
+struct PipelineRun;
+
+// 在途数据项：令牌数量固定，数据项走完所有级（或输入结束）后令牌回到空闲链表
+struct PipelineToken {
+	PipelineRun* run;
+	void* item;
+	uint64_t sequence;       // 输入顺序
+	uint32_t stage;          // 下一个要执行的级
+	bool owned;              // 已持有 stage 对应的串行级（由释放该级的线程转交）
+	PipelineToken* next;     // 空闲链表 / 转交链表
+};
+
+// 串行级的状态
+// 按序级：在途数据项的序号都不小于 nextSequence（更小的已经通过），且不超过 maxTokens 个，
+// 所以按 sequence % maxTokens 存放等待的数据项不会冲突
+struct PipelineSerialStage {
+	std::mutex mutex;
+	bool busy;
+	uint64_t nextSequence;
+	std::vector<PipelineToken*> ordered;
+	std::deque<PipelineToken*> unordered;
+
+	PipelineSerialStage() : busy(false), nextSequence(0) {}
+};
+
+// 一次 Launch 的状态，由最后退出的执行者释放（输入结束、令牌全部归还、没有其他执行者）
+// 最后一个执行者退出时流水线已经结束，不需要额外的清理 Job
+//
+// 执行者（runner）Job 循环处理：先处理转交给自己的数据项，再读取新的输入，都没有时退出。
+// 数据项不为每一级创建 Job：并行级直接调用，串行级空闲时直接进入，
+// 被占用时排队，由释放该级的执行者接手。新的执行者只在读到输入后、仍有空闲令牌时创建，
+// 所以创建的 Job 数量与并行度相关，而不是与数据项数量成正比
+struct PipelineRun {
+	JobSystem* jobSystem;
+	const ParallelPipeline* pipeline;
+	Job* root;
+	uint32_t maxTokens;
+	uint32_t maxRunners;
+
+	std::unique_ptr<PipelineToken[]> tokens;
+	std::unique_ptr<PipelineSerialStage[]> serialStages;
+
+	// 输入级与令牌状态
+	std::mutex inputMutex;
+	PipelineToken* freeTokens;
+	uint32_t tokensInFlight;
+	uint32_t runners;
+	uint64_t nextSequence;
+	bool inputBusy;
+	bool inputDone;
+
+	void RunnerLoop(Job* job);
+	PipelineToken* ReadInput(Job* job);
+	void Process(PipelineToken* token, PipelineToken*& handoff);
+	void Retire(PipelineToken* token);
+	bool Acquire(PipelineSerialStage& serial, PipelineToken* token, bool inOrder);
+	PipelineToken* Release(PipelineSerialStage& serial, bool inOrder);
+
+	static void RootJob(Job* job, void* data);
+	static void RunnerJob(Job* job, void* data);
+};
+
+void PipelineRun::RunnerLoop(Job* job)
+{
+	PipelineToken* handoff = nullptr;
+	for (;;) {
+		PipelineToken* token = handoff;
+		if (token) {
+			handoff = token->next;
+		} else {
+			token = ReadInput(job);
+		}
+		if (!token) {
+			break;
+		}
+		Process(token, handoff);
+	}
+
+	// 输入被其他执行者占用、令牌用完或输入结束：在途的数据项由持有它们的执行者继续
+	bool last;
+	{
+		std::lock_guard<std::mutex> lock(inputMutex);
+		runners--;
+		last = runners == 0 && inputDone && tokensInFlight == 0;
+	}
+	if (last) {
+		delete this;
+	}
+}
+
+PipelineToken* PipelineRun::ReadInput(Job* job)
+{
+	PipelineToken* token;
+	{
+		std::lock_guard<std::mutex> lock(inputMutex);
+		if (inputBusy || inputDone || tokensInFlight >= maxTokens) {
+			return nullptr;
+		}
+		inputBusy = true;
+		tokensInFlight++;
+		token = freeTokens;
+		freeTokens = token->next;
+	}
+
+	// 取消只停止输入
+	void* item = nullptr;
+	if (!JobSystem::IsCancelled(job)) {
+		item = pipeline->stages[0].func(nullptr);
+	}
+
+	bool spawnRunner = false;
+	{
+		std::lock_guard<std::mutex> lock(inputMutex);
+		inputBusy = false;
+		if (!item) {
+			inputDone = true;
+			token->next = freeTokens;
+			freeTokens = token;
+			tokensInFlight--;
+			return nullptr;
+		}
+		token->sequence = nextSequence++;
+		if (tokensInFlight < maxTokens && runners < maxRunners) {
+			runners++;
+			spawnRunner = true;
+		}
+	}
+
+	// 还有空闲令牌：再开一个执行者读取下一项，本执行者接着处理刚读到的数据项
+	if (spawnRunner) {
+		Job* runner = jobSystem->CreateJob(root, RunnerJob);
+		runner->data = this;
+		runner->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
+		jobSystem->RunJob(runner);
+	}
+
+	token->item = item;
+	token->stage = 1;
+	token->owned = false;
+	return token;
+}
+
+void PipelineRun::Retire(PipelineToken* token)
+{
+	std::lock_guard<std::mutex> lock(inputMutex);
+	token->next = freeTokens;
+	freeTokens = token;
+	tokensInFlight--;
+}
+
+bool PipelineRun::Acquire(PipelineSerialStage& serial, PipelineToken* token, bool inOrder)
+{
+	std::lock_guard<std::mutex> lock(serial.mutex);
+	if (!serial.busy && (!inOrder || token->sequence == serial.nextSequence)) {
+		serial.busy = true;
+		return true;
+	}
+	if (inOrder) {
+		serial.ordered[token->sequence % maxTokens] = token;
+	} else {
+		serial.unordered.push_back(token);
+	}
+	return false;
+}
+
+PipelineToken* PipelineRun::Release(PipelineSerialStage& serial, bool inOrder)
+{
+	// 有等待的数据项时该级保持占用，直接转交给它
+	std::lock_guard<std::mutex> lock(serial.mutex);
+	PipelineToken* next = nullptr;
+	if (inOrder) {
+		serial.nextSequence++;
+		PipelineToken*& slot = serial.ordered[serial.nextSequence % maxTokens];
+		next = slot;
+		slot = nullptr;
+	} else if (!serial.unordered.empty()) {
+		next = serial.unordered.front();
+		serial.unordered.pop_front();
+	}
+	serial.busy = next != nullptr;
+	return next;
+}
+
+void PipelineRun::Process(PipelineToken* token, PipelineToken*& handoff)
+{
+	const std::vector<ParallelPipeline::Stage>& stages = pipeline->stages;
+	for (; token->stage < stages.size(); token->stage++) {
+		const ParallelPipeline::Stage& stage = stages[token->stage];
+		if (stage.kind == JOB_PIPELINE_PARALLEL) {
+			if (token->item) token->item = stage.func(token->item);
+			continue;
+		}
+
+		// 串行级：被占用时排队，本执行者去做别的
+		// 被丢弃的数据项同样要经过按序级，否则后面的序号永远等不到它
+		const bool inOrder = stage.kind == JOB_PIPELINE_SERIAL_IN_ORDER;
+		PipelineSerialStage& serial = serialStages[token->stage];
+		if (!token->owned && !Acquire(serial, token, inOrder)) {
+			return;
+		}
+		token->owned = false;
+
+		if (token->item) token->item = stage.func(token->item);
+
+		// 排队的数据项连同该级的占用一起转交给本执行者，当前数据项继续走后面的级
+		PipelineToken* next = Release(serial, inOrder);
+		if (next) {
+			next->owned = true;
+			next->next = handoff;
+			handoff = next;
+		}
+	}
+	Retire(token);
+}
+
+void PipelineRun::RootJob(Job* job, void* data)
+{
+	// 根 Job 是第一个执行者
+	static_cast<PipelineRun*>(data)->RunnerLoop(job);
+}
+
+void PipelineRun::RunnerJob(Job* job, void* data)
+{
+	static_cast<PipelineRun*>(data)->RunnerLoop(job);
+}
+
+// ====== ParallelPipeline ======
+
+void ParallelPipeline::AddStage(JobPipelineStageKind kind, JobPipelineStageCallback callback, void* userData)
+{
+	AddStage(kind, [callback, userData](void* item) { return callback(item, userData); });
+}
+
+Job* ParallelPipeline::Launch(JobSystem& jobSystem, uint32_t maxTokens, Job* parent) const
+{
+	if (stages.empty()) {
+		return nullptr;
+	}
+	if (maxTokens == 0) {
+		maxTokens = static_cast<uint32_t>(jobSystem.GetThreadCount()) * 2;
+	}
+
+	PipelineRun* run = new PipelineRun();
+	run->jobSystem = &jobSystem;
+	run->pipeline = this;
+	run->maxTokens = maxTokens;
+	run->maxRunners = static_cast<uint32_t>(jobSystem.GetThreadCount());
+	run->tokens.reset(new PipelineToken[maxTokens]);
+	for (uint32_t i = 0; i < maxTokens; i++) {
+		run->tokens[i].run = run;
+		run->tokens[i].next = i + 1 < maxTokens ? &run->tokens[i + 1] : nullptr;
+	}
+	run->freeTokens = &run->tokens[0];
+	run->tokensInFlight = 0;
+	run->runners = 1;
+	run->nextSequence = 0;
+	run->inputBusy = false;
+	run->inputDone = false;
+	run->serialStages.reset(new PipelineSerialStage[stages.size()]);
+	for (size_t i = 1; i < stages.size(); i++) {
+		if (stages[i].kind == JOB_PIPELINE_SERIAL_IN_ORDER) {
+			run->serialStages[i].ordered.assign(maxTokens, nullptr);
+		}
+	}
+
+	Job* root = parent ? jobSystem.CreateJob(parent, PipelineRun::RootJob) : jobSystem.CreateJob(PipelineRun::RootJob);
+	root->data = run;
+	root->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
+	run->root = root;
+	return root;
+}
+
+void parallel_pipeline(JobSystem* jobSystem, uint32_t maxTokens, const ParallelPipeline& pipeline)
+{
+	Job* root = pipeline.Launch(*jobSystem, maxTokens);
+	if (root) {
+		jobSystem->RunJob(root);
+		jobSystem->WaitJob(root);
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "Job.h"
+#include "JobSystemCAPI.h"
+
+class JobSystem;
+
+// ====== 多级流水线 ======
+// 数据项依次经过各级处理，同时在途的数据项不超过 maxTokens 个（内存有界）
+// - 第 0 级为输入级：以 nullptr 调用，串行执行，返回 nullptr 表示输入结束（该级的类型被忽略）
+// - 之后每一级把上一级返回的数据项变换为新的数据项；返回 nullptr 表示丢弃，后续各级不再调用
+// - JOB_PIPELINE_SERIAL_IN_ORDER 级同一时刻只处理一个数据项，且按输入顺序；
+//   JOB_PIPELINE_SERIAL_OUT_OF_ORDER 级同一时刻只处理一个数据项，顺序不限；
+//   JOB_PIPELINE_PARALLEL 级可同时处理多个数据项
+// 数据项尽量在同一个线程上走完所有级（缓存局部性），只有在串行级排队时才交给释放该级的线程
+class ParallelPipeline {
+public:
+	typedef std::function<void*(void*)> StageFunction;
+
+	void AddStage(JobPipelineStageKind kind, JobPipelineStageCallback callback, void* userData);
+	template<typename Func>
+	void AddStage(JobPipelineStageKind kind, Func&& func)
+	{
+		Stage stage;
+		stage.kind = kind;
+		stage.func = StageFunction(std::forward<Func>(func));
+		stages.push_back(std::move(stage));
+	}
+	size_t GetStageCount() const { return stages.size(); }
+
+	// 创建本次执行的根 Job（未运行），调用方 RunJob + WaitJob；parent 非空时根 Job 作为它的子 Job
+	// maxTokens 为 0 时使用线程数的 2 倍；没有任何级时返回 nullptr
+	// 同一个流水线可以同时有多次执行在途，执行期间不能修改流水线
+	// 取消根 Job 只停止输入，已在途的数据项仍走完各级（各级可以借此释放数据项）
+	// 根 Job 和执行者 Job 与其他 Job 一样占用创建时所在帧的 Job 缓冲，跨帧的流应在 MAX_FRAMES_IN_FLIGHT 帧内结束
+	Job* Launch(JobSystem& jobSystem, uint32_t maxTokens, Job* parent = nullptr) const;
+
+private:
+	struct Stage {
+		JobPipelineStageKind kind;
+		StageFunction func;
+	};
+
+	std::vector<Stage> stages;
+
+	friend struct PipelineRun;
+};
+
+// 执行流水线并等待输入结束、所有数据项走完
+void parallel_pipeline(JobSystem* jobSystem, uint32_t maxTokens, const ParallelPipeline& pipeline);
@@ -0,0 +1,149 @@
+#pragma once
+#include "JobSystem.h"
+#include "JobSystemCAPI.h"
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// 索引空间 parallel_for：不需要数据指针和元素大小，直接分发 [begin, end) 索引区间
+// 以及 2D/3D 分块（tile）
+//
+// 分割方式：每次沿"剩余分块数最多"的轴在分块边界处二分，直到只剩一个分块。
+// 相邻分块落在同一棵子树里，被同一个工作线程取走的概率更高；
+// 分块形状决定叶子大小，邻域模板（stencil）类内核可以把一个分块及其边界留在 L1/L2 中
+
+static constexpr uint32_t DEFAULT_RANGE_GRAIN_1D = 256;
+static constexpr uint32_t DEFAULT_RANGE_TILE_2D = 64;
+static constexpr uint32_t DEFAULT_RANGE_TILE_3D = 16;
+
+// 区间范围内的分块数量
+inline uint32_t parallel_range_tiles(uint32_t begin, uint32_t end, uint32_t tile) {
+    return end > begin ? (end - begin + tile - 1) / tile : 0;
+}
+
+// 分块 parallel_for 的数据结构
+template<typename Func>
+struct ParallelRangeData {
+    JobSystem* jobSystem;
+    ParallelRange3D range;
+    uint32_t tileX;
+    uint32_t tileY;
+    uint32_t tileZ;
+    Func func;
+};
+
+// 分块 parallel_for 作业函数
+template<typename Func>
+void ParallelRangeJob(Job* job, void* jobData) {
+    auto* rangeData = static_cast<ParallelRangeData<Func>*>(jobData);
+
+    // 已取消：不再执行和分割，只释放数据
+    if (JobSystem::IsCancelled(job)) {
+        delete rangeData;
+        return;
+    }
+
+    const ParallelRange3D& range = rangeData->range;
+    const uint32_t tilesX = parallel_range_tiles(range.beginX, range.endX, rangeData->tileX);
+    const uint32_t tilesY = parallel_range_tiles(range.beginY, range.endY, rangeData->tileY);
+    const uint32_t tilesZ = parallel_range_tiles(range.beginZ, range.endZ, rangeData->tileZ);
+
+    // 只剩一个分块：执行用户函数
+    if (tilesX <= 1 && tilesY <= 1 && tilesZ <= 1) {
+        rangeData->func(range);
+        delete rangeData;
+        return;
+    }
+
+    // 沿分块数最多的轴二分（切点对齐到分块边界）
+    ParallelRange3D left = range;
+    ParallelRange3D right = range;
+    if (tilesX >= tilesY && tilesX >= tilesZ) {
+        const uint32_t mid = range.beginX + (tilesX / 2) * rangeData->tileX;
+        left.endX = mid;
+        right.beginX = mid;
+    } else if (tilesY >= tilesZ) {
+        const uint32_t mid = range.beginY + (tilesY / 2) * rangeData->tileY;
+        left.endY = mid;
+        right.beginY = mid;
+    } else {
+        const uint32_t mid = range.beginZ + (tilesZ / 2) * rangeData->tileZ;
+        left.endZ = mid;
+        right.beginZ = mid;
+    }
+
+    auto* leftData = new ParallelRangeData<Func>{
+        rangeData->jobSystem, left,
+        rangeData->tileX, rangeData->tileY, rangeData->tileZ,
+        rangeData->func
+    };
+    Job* leftJob = rangeData->jobSystem->CreateJob(job, ParallelRangeJob<Func>);
+    leftJob->data = leftData;
+    leftJob->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
+    rangeData->jobSystem->RunJob(leftJob);
+
+    // 右半部分复用当前数据，避免一次拷贝
+    rangeData->range = right;
+    Job* rightJob = rangeData->jobSystem->CreateJob(job, ParallelRangeJob<Func>);
+    rightJob->data = rangeData;
+    rightJob->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
+    rangeData->jobSystem->RunJob(rightJob);
+}
+
+// 3D 分块 parallel_for：func(const ParallelRange3D& tile)
+// tileX/tileY/tileZ 为 0 时使用默认值 16
+// 返回: 根 Job 指针，调用方需 RunJob + WaitJob
+template<typename Func>
+Job* parallel_for_range_3d(JobSystem* jobSystem, const ParallelRange3D& range,
+                           uint32_t tileX, uint32_t tileY, uint32_t tileZ, Func&& func) {
+    Job* rootJob = jobSystem->CreateJob([](Job*, void*) {
+        // 空的根作业，只用于等待所有子作业完成
+    });
+
+    if (range.endX <= range.beginX || range.endY <= range.beginY || range.endZ <= range.beginZ) {
+        return rootJob;
+    }
+
+    using FuncType = typename std::decay<Func>::type;
+    auto* rangeData = new ParallelRangeData<FuncType>{
+        jobSystem, range,
+        tileX > 0 ? tileX : DEFAULT_RANGE_TILE_3D,
+        tileY > 0 ? tileY : DEFAULT_RANGE_TILE_3D,
+        tileZ > 0 ? tileZ : DEFAULT_RANGE_TILE_3D,
+        std::forward<Func>(func)
+    };
+
+    Job* firstJob = jobSystem->CreateJob(rootJob, ParallelRangeJob<FuncType>);
+    firstJob->data = rangeData;
+    firstJob->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
+    jobSystem->RunJob(firstJob);
+
+    return rootJob;
+}
+
+// 2D 分块 parallel_for：func(const ParallelRange3D& tile)，tile 的 z 范围固定为 [0, 1)
+// tileX/tileY 为 0 时使用默认值 64
+template<typename Func>
+Job* parallel_for_range_2d(JobSystem* jobSystem,
+                           uint32_t beginX, uint32_t endX, uint32_t beginY, uint32_t endY,
+                           uint32_t tileX, uint32_t tileY, Func&& func) {
+    const ParallelRange3D range = { beginX, endX, beginY, endY, 0, 1 };
+    return parallel_for_range_3d(jobSystem, range,
+                                 tileX > 0 ? tileX : DEFAULT_RANGE_TILE_2D,
+                                 tileY > 0 ? tileY : DEFAULT_RANGE_TILE_2D,
+                                 1, std::forward<Func>(func));
+}
+
+// 1D 索引区间 parallel_for：func(uint32_t begin, uint32_t end)
+// grainSize 为每个叶子的最大索引数量，0 时使用默认值 256
+template<typename Func>
+Job* parallel_for_range(JobSystem* jobSystem, uint32_t begin, uint32_t end, uint32_t grainSize, Func&& func) {
+    const ParallelRange3D range = { begin, end, 0, 1, 0, 1 };
+    using FuncType = typename std::decay<Func>::type;
+    FuncType rangeFunc(std::forward<Func>(func));
+    return parallel_for_range_3d(jobSystem, range,
+                                 grainSize > 0 ? grainSize : DEFAULT_RANGE_GRAIN_1D, 1, 1,
+                                 [rangeFunc](const ParallelRange3D& r) mutable {
+                                     rangeFunc(r.beginX, r.endX);
+                                 });
+}
@@ -0,0 +1,344 @@
+#include "ParticleCollision.h"
+#include "JobSystem.h"
+#include "ParallelForC.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+
+static constexpr uint32_t DEFAULT_GRID_BATCH_SIZE = 1024;
+static constexpr uint32_t SCAN_BLOCK_SIZE = 4096;
+
+struct ParticleGrid {
+    uint32_t capacity;
+    uint32_t tableSize;                    // 2 的幂
+    uint32_t scanBlockCount;
+
+    uint32_t* cellOf;                      // 每个粒子所在的哈希桶
+    std::atomic<uint32_t>* cellCount;      // 桶计数，分发阶段复用为写入游标
+    uint32_t* cellStart;                   // 桶起始位置（tableSize + 1 项）
+    uint32_t* blockSum;                    // 前缀和分块的局部和
+    uint32_t* sortedIndex;                 // 按桶排序的粒子索引
+    float3* sortedPosition;                // 排序后的位置快照
+    float3* sortedVelocity;                // 排序后的速度快照
+
+    // 本帧状态（提交时写入，Job 中只读）
+    JobSystem* jobSystem;
+    ParticleData* particles;
+    uint32_t count;
+    uint32_t batchSize;
+    PhysicsParams params;
+    float inverseCellSize;
+};
+
+static void EmptyGridJob(Job*, void*) {
+}
+
+static inline uint32_t NextPowerOfTwo(uint32_t v) {
+    uint32_t p = 1;
+    while (p < v && p < 0x80000000u) p <<= 1;
+    return p;
+}
+
+static inline int32_t CellCoord(float v, float inverseCellSize) {
+    return static_cast<int32_t>(std::floor(v * inverseCellSize));
+}
+
+static inline uint32_t HashCell(int32_t x, int32_t y, int32_t z, uint32_t tableSize) {
+    const uint32_t h = (static_cast<uint32_t>(x) * 73856093u) ^
+                       (static_cast<uint32_t>(y) * 19349663u) ^
+                       (static_cast<uint32_t>(z) * 83492791u);
+    return h & (tableSize - 1);
+}
+
+// ====== 阶段 1：计数 ======
+
+static void CountChunk(uint32_t begin, uint32_t end, uint32_t, void* userData) {
+    ParticleGrid* grid = static_cast<ParticleGrid*>(userData);
+    const float inv = grid->inverseCellSize;
+
+    for (uint32_t i = begin; i < end; i++) {
+        const float3& p = grid->particles[i].position;
+        const uint32_t h = HashCell(CellCoord(p.x, inv), CellCoord(p.y, inv), CellCoord(p.z, inv), grid->tableSize);
+        grid->cellOf[i] = h;
+        grid->cellCount[h].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static void CountPhaseJob(Job* job, void* data) {
+    ParticleGrid* grid = static_cast<ParticleGrid*>(data);
+    for (uint32_t i = 0; i < grid->tableSize; i++) {
+        grid->cellCount[i].store(0, std::memory_order_relaxed);
+    }
+    parallel_for_chunks_c(grid->jobSystem, job, grid->count, grid->batchSize, CountChunk, grid);
+}
+
+// ====== 阶段 2：前缀和（分块求和） ======
+
+static void BlockSumChunk(uint32_t begin, uint32_t end, uint32_t, void* userData) {
+    ParticleGrid* grid = static_cast<ParticleGrid*>(userData);
+
+    for (uint32_t b = begin; b < end; b++) {
+        const uint32_t cellBegin = b * SCAN_BLOCK_SIZE;
+        const uint32_t cellEnd = std::min(grid->tableSize, cellBegin + SCAN_BLOCK_SIZE);
+        uint32_t sum = 0;
+        for (uint32_t c = cellBegin; c < cellEnd; c++) {
+            sum += grid->cellCount[c].load(std::memory_order_relaxed);
+        }
+        grid->blockSum[b] = sum;
+    }
+}
+
+static void BlockSumPhaseJob(Job* job, void* data) {
+    ParticleGrid* grid = static_cast<ParticleGrid*>(data);
+    parallel_for_chunks_c(grid->jobSystem, job, grid->scanBlockCount, 1, BlockSumChunk, grid);
+}
+
+// ====== 阶段 3：前缀和（块间扫描 + 块内扫描） ======
+
+static void BlockScanChunk(uint32_t begin, uint32_t end, uint32_t, void* userData) {
+    ParticleGrid* grid = static_cast<ParticleGrid*>(userData);
+
+    for (uint32_t b = begin; b < end; b++) {
+        const uint32_t cellBegin = b * SCAN_BLOCK_SIZE;
+        const uint32_t cellEnd = std::min(grid->tableSize, cellBegin + SCAN_BLOCK_SIZE);
+        uint32_t offset = grid->blockSum[b];
+        for (uint32_t c = cellBegin; c < cellEnd; c++) {
+            const uint32_t n = grid->cellCount[c].load(std::memory_order_relaxed);
+            grid->cellStart[c] = offset;
+            // 计数数组改作分发阶段的写入游标
+            grid->cellCount[c].store(offset, std::memory_order_relaxed);
+            offset += n;
+        }
+    }
+}
+
+static void ScanPhaseJob(Job* job, void* data) {
+    ParticleGrid* grid = static_cast<ParticleGrid*>(data);
+
+    // blockSum 就地转换为各块的起始偏移
+    uint32_t offset = 0;
+    for (uint32_t b = 0; b < grid->scanBlockCount; b++) {
+        const uint32_t sum = grid->blockSum[b];
+        grid->blockSum[b] = offset;
+        offset += sum;
+    }
+    grid->cellStart[grid->tableSize] = offset;
+
+    parallel_for_chunks_c(grid->jobSystem, job, grid->scanBlockCount, 1, BlockScanChunk, grid);
+}
+
+// ====== 阶段 4：分发 ======
+
+static void ScatterChunk(uint32_t begin, uint32_t end, uint32_t, void* userData) {
+    ParticleGrid* grid = static_cast<ParticleGrid*>(userData);
+
+    for (uint32_t i = begin; i < end; i++) {
+        const uint32_t slot = grid->cellCount[grid->cellOf[i]].fetch_add(1, std::memory_order_relaxed);
+        grid->sortedIndex[slot] = i;
+        grid->sortedPosition[slot] = grid->particles[i].position;
+        grid->sortedVelocity[slot] = grid->particles[i].velocity;
+    }
+}
+
+static void ScatterPhaseJob(Job* job, void* data) {
+    ParticleGrid* grid = static_cast<ParticleGrid*>(data);
+    parallel_for_chunks_c(grid->jobSystem, job, grid->count, grid->batchSize, ScatterChunk, grid);
+}
+
+// ====== 阶段 5：碰撞分离 ======
+
+static void CollideRange(const ParticleGrid* grid, uint32_t begin, uint32_t end) {
+    const PhysicsParams& params = grid->params;
+    const float inv = grid->inverseCellSize;
+    const float minDistance = params.particleRadius * 2.0f;
+    const float minDistanceSq = minDistance * minDistance;
+    const float restitution = 0.5f * (1.0f + params.bounceCoefficient);
+
+    for (uint32_t i = begin; i < end; i++) {
+        ParticleData& particle = grid->particles[i];
+        const float3 p = particle.position;
+        const int32_t cx = CellCoord(p.x, inv);
+        const int32_t cy = CellCoord(p.y, inv);
+        const int32_t cz = CellCoord(p.z, inv);
+
+        // 不同单元可能哈希到同一个桶，去重避免重复计算
+        uint32_t buckets[27];
+        uint32_t bucketCount = 0;
+        for (int32_t dz = -1; dz <= 1; dz++)
+            for (int32_t dy = -1; dy <= 1; dy++)
+                for (int32_t dx = -1; dx <= 1; dx++)
+                    buckets[bucketCount++] = HashCell(cx + dx, cy + dy, cz + dz, grid->tableSize);
+        std::sort(buckets, buckets + bucketCount);
+        bucketCount = static_cast<uint32_t>(std::unique(buckets, buckets + bucketCount) - buckets);
+
+        float3 correction;
+        float3 impulse;
+        for (uint32_t b = 0; b < bucketCount; b++) {
+            const uint32_t slotEnd = grid->cellStart[buckets[b] + 1];
+            for (uint32_t slot = grid->cellStart[buckets[b]]; slot < slotEnd; slot++) {
+                if (grid->sortedIndex[slot] == i) continue;
+
+                const float3& q = grid->sortedPosition[slot];
+                const float3 d(p.x - q.x, p.y - q.y, p.z - q.z);
+                const float distSq = d.x * d.x + d.y * d.y + d.z * d.z;
+                if (distSq >= minDistanceSq || distSq <= 1e-12f) continue;
+
+                const float dist = std::sqrt(distSq);
+                const float3 n = d * (1.0f / dist);
+
+                // 位置：双方各承担一半穿透
+                correction += n * (0.5f * (minDistance - dist) * params.collisionStiffness);
+
+                // 速度：只处理相互靠近的分量
+                const float3& v = grid->sortedVelocity[slot];
+                const float approach = (particle.velocity.x - v.x) * n.x +
+                                       (particle.velocity.y - v.y) * n.y +
+                                       (particle.velocity.z - v.z) * n.z;
+                if (approach < 0.0f) {
+                    impulse += n * (-approach * restitution);
+                }
+            }
+        }
+
+        particle.position += correction;
+        particle.velocity += impulse;
+    }
+}
+
+static void CollideChunk(uint32_t begin, uint32_t end, uint32_t, void* userData) {
+    CollideRange(static_cast<const ParticleGrid*>(userData), begin, end);
+}
+
+static void CollidePhaseJob(Job* job, void* data) {
+    ParticleGrid* grid = static_cast<ParticleGrid*>(data);
+    parallel_for_chunks_c(grid->jobSystem, job, grid->count, grid->batchSize, CollideChunk, grid);
+}
+
+// 依次串联各阶段：每个阶段是 rootJob 的子 Job，并作为上一阶段的 continuation 运行
+static Job* RunGridPhases(JobSystem* system, ParticleGrid* grid, const JobFunction* phases, uint32_t phaseCount) {
+    Job* rootJob = system->CreateJob(EmptyGridJob);
+
+    Job* previous = nullptr;
+    Job* first = nullptr;
+    for (uint32_t i = 0; i < phaseCount; i++) {
+        Job* phase = system->CreateJob(rootJob, phases[i]);
+        phase->data = grid;
+        if (previous) {
+            system->AddContinuation(previous, phase);
+        } else {
+            first = phase;
+        }
+        previous = phase;
+    }
+
+    system->RunJob(first);
+    return rootJob;
+}
+
+static bool PrepareGrid(JobSystem* system, ParticleGrid* grid, ParticleData* particles,
+                        uint32_t count, const PhysicsParams* params, uint32_t threshold) {
+    if (!system || !grid || !particles || !params || count == 0 || count > grid->capacity) {
+        return false;
+    }
+
+    // 单元不小于碰撞距离，27 个相邻单元才能覆盖所有可能接触的粒子
+    const float cellSize = std::max(params->cellSize, params->particleRadius * 2.0f);
+    if (!(cellSize > 0.0f)) {
+        return false;
+    }
+
+    grid->jobSystem = system;
+    grid->particles = particles;
+    grid->count = count;
+    grid->batchSize = threshold > 0 ? threshold : DEFAULT_GRID_BATCH_SIZE;
+    grid->params = *params;
+    grid->inverseCellSize = 1.0f / cellSize;
+    return true;
+}
+
+JOBSYSTEM_C_API ParticleGrid* ParticleGrid_Create(uint32_t capacity, uint32_t tableSize) {
+    if (capacity == 0) return nullptr;
+
+    ParticleGrid* grid = new (std::nothrow) ParticleGrid();
+    if (!grid) return nullptr;
+
+    grid->capacity = capacity;
+    grid->tableSize = NextPowerOfTwo(tableSize > 0 ? tableSize : capacity * 2);
+    grid->scanBlockCount = parallel_chunk_count_c(grid->tableSize, SCAN_BLOCK_SIZE);
+    grid->cellOf = new (std::nothrow) uint32_t[capacity];
+    grid->cellCount = new (std::nothrow) std::atomic<uint32_t>[grid->tableSize];
+    grid->cellStart = new (std::nothrow) uint32_t[grid->tableSize + 1];
+    grid->blockSum = new (std::nothrow) uint32_t[grid->scanBlockCount];
+    grid->sortedIndex = new (std::nothrow) uint32_t[capacity];
+    grid->sortedPosition = new (std::nothrow) float3[capacity];
+    grid->sortedVelocity = new (std::nothrow) float3[capacity];
+    grid->jobSystem = nullptr;
+    grid->particles = nullptr;
+    grid->count = 0;
+
+    if (!grid->cellOf || !grid->cellCount || !grid->cellStart || !grid->blockSum ||
+        !grid->sortedIndex || !grid->sortedPosition || !grid->sortedVelocity) {
+        ParticleGrid_Destroy(grid);
+        return nullptr;
+    }
+
+    return grid;
+}
+
+JOBSYSTEM_C_API void ParticleGrid_Destroy(ParticleGrid* grid) {
+    if (!grid) return;
+
+    delete[] grid->cellOf;
+    delete[] grid->cellCount;
+    delete[] grid->cellStart;
+    delete[] grid->blockSum;
+    delete[] grid->sortedIndex;
+    delete[] grid->sortedPosition;
+    delete[] grid->sortedVelocity;
+    delete grid;
+}
+
+JOBSYSTEM_C_API Job* JobSystem_BuildParticleGrid(
+    JobSystem* system,
+    ParticleGrid* grid,
+    ParticleData* particles,
+    uint32_t count,
+    const PhysicsParams* params,
+    uint32_t threshold
+) {
+    if (!PrepareGrid(system, grid, particles, count, params, threshold)) {
+        return nullptr;
+    }
+
+    static const JobFunction phases[] = { CountPhaseJob, BlockSumPhaseJob, ScanPhaseJob, ScatterPhaseJob };
+    return RunGridPhases(system, grid, phases, 4);
+}
+
+JOBSYSTEM_C_API Job* JobSystem_CollideParticles(
+    JobSystem* system,
+    ParticleGrid* grid,
+    ParticleData* particles,
+    uint32_t count,
+    const PhysicsParams* params,
+    uint32_t threshold
+) {
+    if (!PrepareGrid(system, grid, particles, count, params, threshold)) {
+        return nullptr;
+    }
+
+    static const JobFunction phases[] = { CountPhaseJob, BlockSumPhaseJob, ScanPhaseJob, ScatterPhaseJob, CollidePhaseJob };
+    return RunGridPhases(system, grid, phases, 5);
+}
+
+JOBSYSTEM_C_API void CollideParticlesNative(
+    void* data,
+    uint32_t count,
+    void* userData
+) {
+    const ParticleGrid* grid = static_cast<const ParticleGrid*>(userData);
+    if (!grid || !grid->particles) return;
+
+    const uint32_t begin = static_cast<uint32_t>(static_cast<ParticleData*>(data) - grid->particles);
+    CollideRange(grid, begin, begin + count);
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "JobSystemCAPI.h"
+#include "ParticleUpdateNative.h"
+
+// 粒子间碰撞：均匀网格空间哈希 + 计数排序
+//
+// 每帧流程（全部在 Job 中并行执行）：
+//   1. 计数：计算每个粒子的网格哈希，原子累加桶计数
+//   2. 前缀和：分块求和 -> 块间串行扫描 -> 块内扫描，得到每个桶的起始位置
+//   3. 分发：按桶把粒子索引、位置、速度拷贝到排序后的快照数组
+//   4. 碰撞：每个粒子遍历 27 个相邻单元，只读快照，只写自身（无数据竞争）
+//
+// 网格参数来自 PhysicsParams::cellSize / particleRadius / collisionStiffness
+
+typedef struct ParticleGrid ParticleGrid;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 创建空间哈希网格
+ * capacity: 最大粒子数量
+ * tableSize: 哈希桶数量（向上取整为 2 的幂；0 表示 2 * capacity）
+ * 返回: 网格指针
+ */
+JOBSYSTEM_C_API ParticleGrid* ParticleGrid_Create(uint32_t capacity, uint32_t tableSize);
+
+/**
+ * 销毁空间哈希网格
+ */
+JOBSYSTEM_C_API void ParticleGrid_Destroy(ParticleGrid* grid);
+
+/**
+ * 提交一帧网格构建（计数排序），不执行碰撞
+ * 完成后可用 JobSystem_ParallelForNative + CollideParticlesNative（userData 传 grid）执行碰撞
+ * 返回: 根 Job 指针，调用方需 RunJob + WaitJob
+ */
+JOBSYSTEM_C_API Job* JobSystem_BuildParticleGrid(
+    JobSystem* system,
+    ParticleGrid* grid,
+    ParticleData* particles,
+    uint32_t count,
+    const PhysicsParams* params,
+    uint32_t threshold
+);
+
+/**
+ * 提交一帧网格构建 + 碰撞分离
+ * threshold: 每个分块的粒子数量（0 使用默认值 1024）
+ * 返回: 根 Job 指针，调用方需 RunJob + WaitJob
+ */
+JOBSYSTEM_C_API Job* JobSystem_CollideParticles(
+    JobSystem* system,
+    ParticleGrid* grid,
+    ParticleData* particles,
+    uint32_t count,
+    const PhysicsParams* params,
+    uint32_t threshold
+);
+
+/**
+ * 碰撞分离回调（NativeCallback 签名，可直接传给 JobSystem_ParallelForNative）
+ * data: ParticleData*，必须是最近一次构建 grid 时所用数组的子区间
+ * userData: ParticleGrid*
+ */
+JOBSYSTEM_C_API void CollideParticlesNative(
+    void* data,
+    uint32_t count,
+    void* userData
+);
+
+#ifdef __cplusplus
+}
+#endif
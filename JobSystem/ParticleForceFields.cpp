@@ -0,0 +1,223 @@
+#include "ParticleUpdateNative.h"
+#include "ParticleSimd.h"
+
+// ====== 平铺 curl-noise ======
+
+// 噪声图块边长（格点数），图块在三个方向上周期重复
+static constexpr int CURL_TILE_SIZE = 16;
+static constexpr int CURL_TILE_MASK = CURL_TILE_SIZE - 1;
+
+struct CurlNoiseTile {
+    float3 values[CURL_TILE_SIZE * CURL_TILE_SIZE * CURL_TILE_SIZE];
+
+    static int Index(int x, int y, int z) {
+        return ((z & CURL_TILE_MASK) * CURL_TILE_SIZE + (y & CURL_TILE_MASK)) * CURL_TILE_SIZE + (x & CURL_TILE_MASK);
+    }
+
+    // 随机向量势 psi 经一次平滑后取旋度（周期中心差分），得到无散度的速度场
+    CurlNoiseTile() {
+        const int cellCount = CURL_TILE_SIZE * CURL_TILE_SIZE * CURL_TILE_SIZE;
+        float3* raw = new float3[cellCount];
+        float3* psi = new float3[cellCount];
+
+        SimpleRandom rng(0x9E3779B9u);
+        for (int i = 0; i < cellCount; i++) {
+            raw[i] = float3(rng.NextFloat(-1.0f, 1.0f), rng.NextFloat(-1.0f, 1.0f), rng.NextFloat(-1.0f, 1.0f));
+        }
+
+        for (int z = 0; z < CURL_TILE_SIZE; z++)
+            for (int y = 0; y < CURL_TILE_SIZE; y++)
+                for (int x = 0; x < CURL_TILE_SIZE; x++) {
+                    float3 sum;
+                    for (int dz = -1; dz <= 1; dz++)
+                        for (int dy = -1; dy <= 1; dy++)
+                            for (int dx = -1; dx <= 1; dx++)
+                                sum += raw[Index(x + dx, y + dy, z + dz)];
+                    psi[Index(x, y, z)] = sum * (1.0f / 27.0f);
+                }
+
+        for (int z = 0; z < CURL_TILE_SIZE; z++)
+            for (int y = 0; y < CURL_TILE_SIZE; y++)
+                for (int x = 0; x < CURL_TILE_SIZE; x++) {
+                    const float3& px0 = psi[Index(x - 1, y, z)];
+                    const float3& px1 = psi[Index(x + 1, y, z)];
+                    const float3& py0 = psi[Index(x, y - 1, z)];
+                    const float3& py1 = psi[Index(x, y + 1, z)];
+                    const float3& pz0 = psi[Index(x, y, z - 1)];
+                    const float3& pz1 = psi[Index(x, y, z + 1)];
+
+                    // curl(psi) = (dPz/dy - dPy/dz, dPx/dz - dPz/dx, dPy/dx - dPx/dy)，放大到约 [-1, 1]
+                    values[Index(x, y, z)] = float3(
+                        (py1.z - py0.z) - (pz1.y - pz0.y),
+                        (pz1.x - pz0.x) - (px1.z - px0.z),
+                        (px1.y - px0.y) - (py1.x - py0.x)
+                    ) * 4.0f;
+                }
+
+        delete[] raw;
+        delete[] psi;
+    }
+};
+
+static const CurlNoiseTile& GetCurlNoiseTile() {
+    // C++11 保证局部静态变量的线程安全初始化
+    static const CurlNoiseTile tile;
+    return tile;
+}
+
+// 三线性插值采样（图块坐标，周期重复）
+static inline float3 SampleCurlNoise(const CurlNoiseTile& tile, float x, float y, float z) {
+    const float fx = std::floor(x);
+    const float fy = std::floor(y);
+    const float fz = std::floor(z);
+    const int ix = static_cast<int>(fx);
+    const int iy = static_cast<int>(fy);
+    const int iz = static_cast<int>(fz);
+    const float tx = x - fx;
+    const float ty = y - fy;
+    const float tz = z - fz;
+
+    float3 result;
+    for (int c = 0; c < 8; c++) {
+        const int ox = c & 1;
+        const int oy = (c >> 1) & 1;
+        const int oz = (c >> 2) & 1;
+        const float w = (ox ? tx : 1.0f - tx) * (oy ? ty : 1.0f - ty) * (oz ? tz : 1.0f - tz);
+        result += tile.values[CurlNoiseTile::Index(ix + ox, iy + oy, iz + oz)] * w;
+    }
+    return result;
+}
+
+// ====== 力场计算（4 个粒子一组） ======
+
+struct ForceBlock {
+    Vec4 x, y, z;       // 位置
+    Vec4 ax, ay, az;    // 累加的加速度
+};
+
+// 半径线性衰减：radius <= 0 时恒为 1
+static inline Vec4 Falloff(const ForceField& field, Vec4 dist) {
+    if (field.radius <= 0.0f) {
+        return V4Set1(1.0f);
+    }
+    const Vec4 t = V4Sub(V4Set1(1.0f), V4Mul(dist, V4Set1(1.0f / field.radius)));
+    return V4Max(t, V4Set1(0.0f));
+}
+
+static inline void ApplyAttractor(ForceBlock& b, const ForceField& field) {
+    const Vec4 dx = V4Sub(V4Set1(field.center.x), b.x);
+    const Vec4 dy = V4Sub(V4Set1(field.center.y), b.y);
+    const Vec4 dz = V4Sub(V4Set1(field.center.z), b.z);
+    const Vec4 dist = V4Sqrt(V4Add(V4Add(V4Mul(dx, dx), V4Mul(dy, dy)), V4Add(V4Mul(dz, dz), V4Set1(1e-6f))));
+
+    // 沿单位方向施加 strength * falloff
+    const Vec4 scale = V4Div(V4Mul(V4Set1(field.strength), Falloff(field, dist)), dist);
+    b.ax = V4Add(b.ax, V4Mul(dx, scale));
+    b.ay = V4Add(b.ay, V4Mul(dy, scale));
+    b.az = V4Add(b.az, V4Mul(dz, scale));
+}
+
+static inline void ApplyVortex(ForceBlock& b, const ForceField& field) {
+    const Vec4 dx = V4Sub(b.x, V4Set1(field.center.x));
+    const Vec4 dy = V4Sub(b.y, V4Set1(field.center.y));
+    const Vec4 dz = V4Sub(b.z, V4Set1(field.center.z));
+    const Vec4 axisX = V4Set1(field.axis.x);
+    const Vec4 axisY = V4Set1(field.axis.y);
+    const Vec4 axisZ = V4Set1(field.axis.z);
+
+    // 切向 = axis × d
+    const Vec4 tx = V4Sub(V4Mul(axisY, dz), V4Mul(axisZ, dy));
+    const Vec4 ty = V4Sub(V4Mul(axisZ, dx), V4Mul(axisX, dz));
+    const Vec4 tz = V4Sub(V4Mul(axisX, dy), V4Mul(axisY, dx));
+    const Vec4 tangentLength = V4Sqrt(V4Add(V4Add(V4Mul(tx, tx), V4Mul(ty, ty)), V4Add(V4Mul(tz, tz), V4Set1(1e-6f))));
+    const Vec4 dist = V4Sqrt(V4Add(V4Add(V4Mul(dx, dx), V4Mul(dy, dy)), V4Mul(dz, dz)));
+
+    const Vec4 scale = V4Div(V4Mul(V4Set1(field.strength), Falloff(field, dist)), tangentLength);
+    b.ax = V4Add(b.ax, V4Mul(tx, scale));
+    b.ay = V4Add(b.ay, V4Mul(ty, scale));
+    b.az = V4Add(b.az, V4Mul(tz, scale));
+}
+
+static inline void ApplyWind(ForceBlock& b, const ForceField& field) {
+    const Vec4 dx = V4Abs(V4Sub(b.x, V4Set1(field.center.x)));
+    const Vec4 dy = V4Abs(V4Sub(b.y, V4Set1(field.center.y)));
+    const Vec4 dz = V4Abs(V4Sub(b.z, V4Set1(field.center.z)));
+    const Mask4 inside = M4And(M4And(V4LessEqual(dx, V4Set1(field.extents.x)),
+                                     V4LessEqual(dy, V4Set1(field.extents.y))),
+                               V4LessEqual(dz, V4Set1(field.extents.z)));
+
+    b.ax = V4Add(b.ax, V4Select(inside, V4Set1(field.axis.x * field.strength)));
+    b.ay = V4Add(b.ay, V4Select(inside, V4Set1(field.axis.y * field.strength)));
+    b.az = V4Add(b.az, V4Select(inside, V4Set1(field.axis.z * field.strength)));
+}
+
+static inline void ApplyTurbulence(ForceBlock& b, const ForceField& field, const CurlNoiseTile& tile) {
+    // 查表需要按通道取址，采样为标量，缩放与衰减为 SIMD
+    float px[4], py[4], pz[4];
+    V4Store(b.x, px);
+    V4Store(b.y, py);
+    V4Store(b.z, pz);
+
+    float3 n[4];
+    for (int k = 0; k < 4; k++) {
+        n[k] = SampleCurlNoise(tile, px[k] * field.frequency, py[k] * field.frequency, pz[k] * field.frequency);
+    }
+
+    const Vec4 dx = V4Sub(b.x, V4Set1(field.center.x));
+    const Vec4 dy = V4Sub(b.y, V4Set1(field.center.y));
+    const Vec4 dz = V4Sub(b.z, V4Set1(field.center.z));
+    const Vec4 dist = V4Sqrt(V4Add(V4Add(V4Mul(dx, dx), V4Mul(dy, dy)), V4Mul(dz, dz)));
+    const Vec4 scale = V4Mul(V4Set1(field.strength), Falloff(field, dist));
+
+    b.ax = V4Add(b.ax, V4Mul(V4Set(n[0].x, n[1].x, n[2].x, n[3].x), scale));
+    b.ay = V4Add(b.ay, V4Mul(V4Set(n[0].y, n[1].y, n[2].y, n[3].y), scale));
+    b.az = V4Add(b.az, V4Mul(V4Set(n[0].z, n[1].z, n[2].z, n[3].z), scale));
+}
+
+extern "C" void ApplyForceFieldsNative(
+    ParticleData* particles,
+    uint32_t count,
+    const ForceField* fields,
+    uint32_t fieldCount,
+    float deltaTime
+) {
+    if (!particles || !fields || fieldCount == 0) return;
+
+    const CurlNoiseTile& tile = GetCurlNoiseTile();
+
+    for (uint32_t i = 0; i < count; i += 4) {
+        // 尾部不足 4 个时重复最后一个粒子，只写回有效通道
+        const uint32_t lanes = count - i < 4 ? count - i : 4;
+        ParticleData* p[4];
+        for (uint32_t k = 0; k < 4; k++) {
+            p[k] = &particles[i + (k < lanes ? k : lanes - 1)];
+        }
+
+        ForceBlock b;
+        b.x = V4Set(p[0]->position.x, p[1]->position.x, p[2]->position.x, p[3]->position.x);
+        b.y = V4Set(p[0]->position.y, p[1]->position.y, p[2]->position.y, p[3]->position.y);
+        b.z = V4Set(p[0]->position.z, p[1]->position.z, p[2]->position.z, p[3]->position.z);
+        b.ax = V4Set1(0.0f);
+        b.ay = V4Set1(0.0f);
+        b.az = V4Set1(0.0f);
+
+        for (uint32_t f = 0; f < fieldCount; f++) {
+            const ForceField& field = fields[f];
+            switch (field.type) {
+            case FORCE_FIELD_ATTRACTOR:  ApplyAttractor(b, field); break;
+            case FORCE_FIELD_VORTEX:     ApplyVortex(b, field); break;
+            case FORCE_FIELD_TURBULENCE: ApplyTurbulence(b, field, tile); break;
+            case FORCE_FIELD_WIND:       ApplyWind(b, field); break;
+            default: break;
+            }
+        }
+
+        float ax[4], ay[4], az[4];
+        V4Store(V4Mul(b.ax, V4Set1(deltaTime)), ax);
+        V4Store(V4Mul(b.ay, V4Set1(deltaTime)), ay);
+        V4Store(V4Mul(b.az, V4Set1(deltaTime)), az);
+        for (uint32_t k = 0; k < lanes; k++) {
+            p[k]->velocity += float3(ax[k], ay[k], az[k]);
+        }
+    }
+}
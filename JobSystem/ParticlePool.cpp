@@ -0,0 +1,252 @@
+#include "ParticlePool.h"
+#include "JobSystem.h"
+#include "ParallelForC.h"
+#include <cstring>
+#include <new>
+#include <vector>
+
+static constexpr uint32_t DEFAULT_POOL_BATCH_SIZE = 1024;
+// 分块未执行（被取消）的标记
+static constexpr uint32_t CHUNK_SKIPPED = 0xFFFFFFFFu;
+
+// 每个分块的输出统计
+struct ParticlePoolChunk {
+    uint32_t aliveOut;   // 本块输出的存活粒子数量（含新发射），CHUNK_SKIPPED 表示分块被取消未执行
+    uint32_t deadOut;    // 本块输出的死亡粒子数量
+    uint32_t aliveDst;   // 合并时在存活列表中的目标偏移
+    uint32_t deadDst;    // 合并时在空闲栈中的目标偏移
+};
+
+struct ParticlePool {
+    ParticleData* particles;
+    uint32_t capacity;
+    uint32_t aliveCount;
+    uint32_t freeCount;
+    float emitAccumulator;
+
+    uint32_t* aliveList;      // 紧凑的存活索引
+    uint32_t* freeList;       // 空闲槽位栈（栈顶在 freeCount - 1）
+    uint32_t* aliveScratch;   // 分块存活输出区
+    uint32_t* deadScratch;    // 分块死亡输出区
+    std::vector<ParticlePoolChunk> chunks;
+
+    // 本帧状态（提交时写入，Job 中只读）
+    JobSystem* jobSystem;
+    PhysicsParams params;
+    uint32_t emitCount;
+    uint32_t batchSize;
+    uint32_t chunkCount;
+};
+
+static void EmptyPoolJob(Job*, void*) {
+}
+
+// 分块 chunkIndex 分到的新发射粒子起始序号（均匀分摊到各块）
+static inline uint32_t EmitShareBegin(const ParticlePool* pool, uint32_t chunkIndex) {
+    return static_cast<uint32_t>((uint64_t)pool->emitCount * chunkIndex / pool->chunkCount);
+}
+
+// 更新一个存活分块，并发射本块分到的新粒子
+static void UpdatePoolChunk(uint32_t begin, uint32_t end, uint32_t chunkIndex, void* userData) {
+    ParticlePool* pool = static_cast<ParticlePool*>(userData);
+    const PhysicsParams& params = pool->params;
+    ParticleData* particles = pool->particles;
+
+    const uint32_t emitBegin = EmitShareBegin(pool, chunkIndex);
+    const uint32_t emitEnd = EmitShareBegin(pool, chunkIndex + 1);
+
+    // 本块输出区：存活区起点 = begin + 之前各块的发射总数，死亡区起点 = begin
+    uint32_t* aliveOut = pool->aliveScratch + begin + emitBegin;
+    uint32_t* deadOut = pool->deadScratch + begin;
+    uint32_t aliveN = 0;
+    uint32_t deadN = 0;
+
+    for (uint32_t i = begin; i < end; i++) {
+        const uint32_t index = pool->aliveList[i];
+        ParticleData& particle = particles[index];
+
+        particle.age += params.deltaTime;
+        if (particle.age >= particle.lifetime) {
+            deadOut[deadN++] = index;
+            continue;
+        }
+
+        IntegrateParticle(particle, params);
+        aliveOut[aliveN++] = index;
+    }
+
+    // 新发射的粒子取自空闲栈顶
+    const uint32_t* emitSlots = pool->freeList + (pool->freeCount - pool->emitCount);
+    for (uint32_t e = emitBegin; e < emitEnd; e++) {
+        const uint32_t index = emitSlots[e];
+        ParticleData& particle = particles[index];
+
+        SimpleRandom rng(params.baseSeed + index);
+        SpawnParticle(particle, rng);
+        IntegrateParticle(particle, params);
+        aliveOut[aliveN++] = index;
+    }
+
+    pool->chunks[chunkIndex].aliveOut = aliveN;
+    pool->chunks[chunkIndex].deadOut = deadN;
+}
+
+// 把一个分块的输出压缩到存活列表和空闲栈
+static void CompactPoolChunk(uint32_t begin, uint32_t end, uint32_t, void* userData) {
+    ParticlePool* pool = static_cast<ParticlePool*>(userData);
+
+    for (uint32_t k = begin; k < end; k++) {
+        const ParticlePoolChunk& chunk = pool->chunks[k];
+        const uint32_t srcBegin = k * pool->batchSize;
+
+        memcpy(pool->aliveList + chunk.aliveDst,
+               pool->aliveScratch + srcBegin + EmitShareBegin(pool, k),
+               chunk.aliveOut * sizeof(uint32_t));
+        memcpy(pool->freeList + chunk.deadDst,
+               pool->deadScratch + srcBegin,
+               chunk.deadOut * sizeof(uint32_t));
+    }
+}
+
+// 合并 Job：所有分块完成后计算偏移（前缀和），再并行压缩
+// 取消时也运行：已执行的分块已经杀死 / 发射了粒子，必须合并才能保持存活列表和空闲栈一致
+static void MergePoolJob(Job* job, void* data) {
+    ParticlePool* pool = static_cast<ParticlePool*>(data);
+    const uint32_t oldAliveCount = pool->aliveCount;
+
+    // 被取消的分块：粒子原样保留，分到的发射槽位退回空闲栈（按原顺序压到栈底一侧）
+    const uint32_t emitBase = pool->freeCount - pool->emitCount;
+    uint32_t freeN = emitBase;
+    for (uint32_t k = 0; k < pool->chunkCount; k++) {
+        ParticlePoolChunk& chunk = pool->chunks[k];
+        if (chunk.aliveOut != CHUNK_SKIPPED) {
+            continue;
+        }
+
+        const uint32_t emitBegin = EmitShareBegin(pool, k);
+        const uint32_t emitEnd = EmitShareBegin(pool, k + 1);
+        const uint32_t begin = k * pool->batchSize;
+        const uint32_t end = begin + pool->batchSize < oldAliveCount ? begin + pool->batchSize : oldAliveCount;
+        memcpy(pool->aliveScratch + begin + emitBegin, pool->aliveList + begin, (end - begin) * sizeof(uint32_t));
+        chunk.aliveOut = end - begin;
+        chunk.deadOut = 0;
+        for (uint32_t e = emitBegin; e < emitEnd; e++) {
+            pool->freeList[freeN++] = pool->freeList[emitBase + e];
+        }
+    }
+
+    uint32_t aliveN = 0;
+    for (uint32_t k = 0; k < pool->chunkCount; k++) {
+        ParticlePoolChunk& chunk = pool->chunks[k];
+        chunk.aliveDst = aliveN;
+        chunk.deadDst = freeN;
+        aliveN += chunk.aliveOut;
+        freeN += chunk.deadOut;
+    }
+
+    pool->aliveCount = aliveN;
+    pool->freeCount = freeN;
+
+    // 压缩 Job 作为合并 Job 的子 Job，根 Job 会等待它们完成；取消时子 Job 不会执行，直接在这里压缩
+    if (JobSystem::IsCancelled(job)) {
+        CompactPoolChunk(0, pool->chunkCount, 0, pool);
+    } else {
+        parallel_for_chunks_c(pool->jobSystem, job, pool->chunkCount, 1, CompactPoolChunk, pool);
+    }
+}
+
+JOBSYSTEM_C_API ParticlePool* ParticlePool_Create(ParticleData* particles, uint32_t capacity) {
+    if (!particles || capacity == 0) return nullptr;
+
+    ParticlePool* pool = new (std::nothrow) ParticlePool();
+    if (!pool) return nullptr;
+
+    pool->particles = particles;
+    pool->capacity = capacity;
+    pool->aliveCount = 0;
+    pool->freeCount = capacity;
+    pool->emitAccumulator = 0.0f;
+    pool->aliveList = new (std::nothrow) uint32_t[capacity];
+    pool->freeList = new (std::nothrow) uint32_t[capacity];
+    pool->aliveScratch = new (std::nothrow) uint32_t[capacity];
+    pool->deadScratch = new (std::nothrow) uint32_t[capacity];
+    pool->jobSystem = nullptr;
+    pool->emitCount = 0;
+    pool->batchSize = DEFAULT_POOL_BATCH_SIZE;
+    pool->chunkCount = 0;
+
+    if (!pool->aliveList || !pool->freeList || !pool->aliveScratch || !pool->deadScratch) {
+        ParticlePool_Destroy(pool);
+        return nullptr;
+    }
+
+    // 空闲栈：低索引在栈顶，优先发射
+    for (uint32_t i = 0; i < capacity; i++) {
+        pool->freeList[i] = capacity - 1 - i;
+    }
+
+    return pool;
+}
+
+JOBSYSTEM_C_API void ParticlePool_Destroy(ParticlePool* pool) {
+    if (!pool) return;
+
+    delete[] pool->aliveList;
+    delete[] pool->freeList;
+    delete[] pool->aliveScratch;
+    delete[] pool->deadScratch;
+    delete pool;
+}
+
+JOBSYSTEM_C_API uint32_t ParticlePool_GetAliveCount(const ParticlePool* pool) {
+    return pool ? pool->aliveCount : 0;
+}
+
+JOBSYSTEM_C_API const uint32_t* ParticlePool_GetAliveIndices(const ParticlePool* pool) {
+    return pool ? pool->aliveList : nullptr;
+}
+
+JOBSYSTEM_C_API Job* JobSystem_UpdateParticlePool(
+    JobSystem* system,
+    ParticlePool* pool,
+    const PhysicsParams* params,
+    uint32_t threshold
+) {
+    if (!system || !pool || !params) {
+        return nullptr;
+    }
+
+    pool->jobSystem = system;
+    pool->params = *params;
+    pool->batchSize = threshold > 0 ? threshold : DEFAULT_POOL_BATCH_SIZE;
+
+    // 发射速率累积：不足一个粒子的部分留到下一帧
+    pool->emitAccumulator += params->emitRate * params->deltaTime;
+    uint32_t emitCount = 0;
+    if (pool->emitAccumulator >= 1.0f) {
+        emitCount = static_cast<uint32_t>(pool->emitAccumulator);
+        pool->emitAccumulator -= static_cast<float>(emitCount);
+    }
+    if (emitCount > pool->freeCount) {
+        emitCount = pool->freeCount;
+    }
+    pool->emitCount = emitCount;
+
+    pool->chunkCount = parallel_chunk_count_c(pool->aliveCount, pool->batchSize);
+    pool->chunks.assign(pool->chunkCount, ParticlePoolChunk{ CHUNK_SKIPPED, 0, 0, 0 });
+
+    // rootJob 由调用方运行；mergeJob 和 updateJob 是其子 Job，保证 WaitJob(rootJob) 返回时压缩已完成，
+    // CancelJob(rootJob) 能停止还未执行的更新分块
+    Job* rootJob = system->CreateJob(EmptyPoolJob);
+    Job* mergeJob = system->CreateJob(rootJob, MergePoolJob);
+    mergeJob->data = pool;
+    mergeJob->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
+
+    Job* updateJob = system->CreateJob(rootJob, EmptyPoolJob);
+    system->AddContinuation(updateJob, mergeJob);
+
+    parallel_for_chunks_c(system, updateJob, pool->aliveCount, pool->batchSize, UpdatePoolChunk, pool);
+    system->RunJob(updateJob);
+
+    return rootJob;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "JobSystemCAPI.h"
+#include "ParticleUpdateNative.h"
+
+// 粒子池：维护存活粒子索引列表，每帧只更新存活粒子
+//
+// 每帧流程（全部在 Job 中并行执行）：
+//   1. 按 PhysicsParams::emitRate 计算本帧发射数量，从空闲栈顶取出槽位
+//   2. 存活列表分块并行更新：死亡粒子写入本块的死亡输出区，
+//      存活粒子和本块分到的新发射粒子写入本块的存活输出区（各块区域互不重叠，无锁）
+//   3. 合并 Job 计算各块偏移，并行把输出区压缩回存活列表和空闲栈
+//
+// 粒子的 lifetime、color 由调用方初始化，发射时只重置 age、position、velocity
+
+typedef struct ParticlePool ParticlePool;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 创建粒子池（初始时所有槽位均为空闲）
+ * particles: 调用方持有的粒子数组（生命周期需长于粒子池）
+ * capacity: 粒子数组容量
+ * 返回: 粒子池指针
+ */
+JOBSYSTEM_C_API ParticlePool* ParticlePool_Create(ParticleData* particles, uint32_t capacity);
+
+/**
+ * 销毁粒子池（不释放 particles 数组）
+ */
+JOBSYSTEM_C_API void ParticlePool_Destroy(ParticlePool* pool);
+
+/**
+ * 获取存活粒子数量
+ */
+JOBSYSTEM_C_API uint32_t ParticlePool_GetAliveCount(const ParticlePool* pool);
+
+/**
+ * 获取存活粒子索引数组（长度为 ParticlePool_GetAliveCount）
+ */
+JOBSYSTEM_C_API const uint32_t* ParticlePool_GetAliveIndices(const ParticlePool* pool);
+
+/**
+ * 提交一帧粒子池更新
+ * system: JobSystem 实例指针
+ * pool: 粒子池
+ * params: 物理参数（会被拷贝，调用返回后即可释放）
+ * threshold: 每个分块的存活粒子数量（0 使用默认值 1024）
+ * 返回: 根 Job 指针，调用方需 RunJob + WaitJob；完成前不能再次提交同一个粒子池
+ */
+JOBSYSTEM_C_API Job* JobSystem_UpdateParticlePool(
+    JobSystem* system,
+    ParticlePool* pool,
+    const PhysicsParams* params,
+    uint32_t threshold
+);
+
+#ifdef __cplusplus
+}
+#endif
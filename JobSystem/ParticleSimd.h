@@ -0,0 +1,60 @@
+#pragma once
+// 粒子内核使用的 4 宽 SIMD 辅助（SSE2，其他平台退化为标量数组）
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARTICLE_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <cmath>
+
+#ifdef PARTICLE_SIMD_SSE2
+
+struct Vec4 {
+    __m128 v;
+};
+
+// 比较结果：每个通道全 1 或全 0
+struct Mask4 {
+    __m128 v;
+};
+
+inline Vec4 V4Set1(float a) { Vec4 r; r.v = _mm_set1_ps(a); return r; }
+inline Vec4 V4Set(float a, float b, float c, float d) { Vec4 r; r.v = _mm_setr_ps(a, b, c, d); return r; }
+inline Vec4 V4Add(Vec4 a, Vec4 b) { Vec4 r; r.v = _mm_add_ps(a.v, b.v); return r; }
+inline Vec4 V4Sub(Vec4 a, Vec4 b) { Vec4 r; r.v = _mm_sub_ps(a.v, b.v); return r; }
+inline Vec4 V4Mul(Vec4 a, Vec4 b) { Vec4 r; r.v = _mm_mul_ps(a.v, b.v); return r; }
+inline Vec4 V4Div(Vec4 a, Vec4 b) { Vec4 r; r.v = _mm_div_ps(a.v, b.v); return r; }
+inline Vec4 V4Max(Vec4 a, Vec4 b) { Vec4 r; r.v = _mm_max_ps(a.v, b.v); return r; }
+inline Vec4 V4Abs(Vec4 a) { Vec4 r; r.v = _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); return r; }
+inline Vec4 V4Sqrt(Vec4 a) { Vec4 r; r.v = _mm_sqrt_ps(a.v); return r; }
+inline Mask4 V4LessEqual(Vec4 a, Vec4 b) { Mask4 r; r.v = _mm_cmple_ps(a.v, b.v); return r; }
+inline Mask4 M4And(Mask4 a, Mask4 b) { Mask4 r; r.v = _mm_and_ps(a.v, b.v); return r; }
+inline Vec4 V4Select(Mask4 m, Vec4 a) { Vec4 r; r.v = _mm_and_ps(m.v, a.v); return r; }
+inline void V4Store(Vec4 a, float* out) { _mm_storeu_ps(out, a.v); }
+
+#else
+
+struct Vec4 {
+    float v[4];
+};
+
+struct Mask4 {
+    bool v[4];
+};
+
+inline Vec4 V4Set1(float a) { Vec4 r = { { a, a, a, a } }; return r; }
+inline Vec4 V4Set(float a, float b, float c, float d) { Vec4 r = { { a, b, c, d } }; return r; }
+inline Vec4 V4Add(Vec4 a, Vec4 b) { for (int i = 0; i < 4; i++) a.v[i] += b.v[i]; return a; }
+inline Vec4 V4Sub(Vec4 a, Vec4 b) { for (int i = 0; i < 4; i++) a.v[i] -= b.v[i]; return a; }
+inline Vec4 V4Mul(Vec4 a, Vec4 b) { for (int i = 0; i < 4; i++) a.v[i] *= b.v[i]; return a; }
+inline Vec4 V4Div(Vec4 a, Vec4 b) { for (int i = 0; i < 4; i++) a.v[i] /= b.v[i]; return a; }
+inline Vec4 V4Max(Vec4 a, Vec4 b) { for (int i = 0; i < 4; i++) a.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i]; return a; }
+inline Vec4 V4Abs(Vec4 a) { for (int i = 0; i < 4; i++) a.v[i] = std::fabs(a.v[i]); return a; }
+inline Vec4 V4Sqrt(Vec4 a) { for (int i = 0; i < 4; i++) a.v[i] = std::sqrt(a.v[i]); return a; }
+inline Mask4 V4LessEqual(Vec4 a, Vec4 b) { Mask4 r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] <= b.v[i]; return r; }
+inline Mask4 M4And(Mask4 a, Mask4 b) { for (int i = 0; i < 4; i++) a.v[i] = a.v[i] && b.v[i]; return a; }
+inline Vec4 V4Select(Mask4 m, Vec4 a) { for (int i = 0; i < 4; i++) a.v[i] = m.v[i] ? a.v[i] : 0.0f; return a; }
+inline void V4Store(Vec4 a, float* out) { for (int i = 0; i < 4; i++) out[i] = a.v[i]; }
+
+#endif
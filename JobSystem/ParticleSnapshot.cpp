@@ -0,0 +1,669 @@
+#include "ParticleSnapshot.h"
+#include "JobSystem.h"
+#include "ParallelForC.h"
+#include <atomic>
+#include <cstring>
+#include <cstdio>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static constexpr uint32_t SNAPSHOT_MAGIC = 0x504E5350;   // "PSNP"
+static constexpr uint32_t SNAPSHOT_VERSION = 1;
+static constexpr uint32_t SNAPSHOT_CHUNK_PARTICLES = 16384;   // 每块 1MB 原始数据
+static constexpr uint64_t SNAPSHOT_DATA_ALIGNMENT = 4096;     // 分块数据起点按页对齐，零拷贝映射时 ParticleData 数组对齐
+static constexpr uint64_t SNAPSHOT_CHUNK_ALIGNMENT = 64;
+static constexpr uint32_t SNAPSHOT_CHUNK_COMPRESSED = 1u << 0;
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t particleSize;     // sizeof(ParticleData)
+    uint32_t paramsSize;       // sizeof(PhysicsParams)
+    uint32_t particleCount;
+    uint32_t chunkParticles;
+    uint32_t chunkCount;
+    uint32_t tableChecksum;    // PhysicsParams + 分块表的校验和
+    uint32_t _padding;
+    uint64_t dataOffset;
+    uint64_t fileSize;
+    uint64_t _reserved;
+};
+
+struct SnapshotChunk {
+    uint64_t offset;
+    uint32_t storedSize;
+    uint32_t rawSize;
+    uint32_t checksum;         // 存储字节（压缩后）的校验和
+    uint32_t flags;
+};
+
+static_assert(sizeof(SnapshotHeader) == 64, "SnapshotHeader layout");
+static_assert(sizeof(SnapshotChunk) == 24, "SnapshotChunk layout");
+
+static inline uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// ====== 校验和 ======
+
+// 4 路交错的 FNV 风格散列：每 32 字节 4 次互不依赖的乘法，尾部按字节处理
+static uint32_t SnapshotChecksum(const uint8_t* data, size_t size) {
+    const uint64_t prime = 0x100000001B3ull;
+    uint64_t h[4] = { 0xCBF29CE484222325ull, 0x84222325CBF29CE4ull, 0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full };
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int lane = 0; lane < 4; lane++) {
+            uint64_t word;
+            memcpy(&word, data + i + lane * 8, sizeof(word));
+            h[lane] = (h[lane] ^ word) * prime;
+        }
+    }
+    uint64_t result = (h[0] ^ (h[1] >> 1) ^ (h[2] >> 2) ^ (h[3] >> 3)) + size;
+    for (; i < size; i++) {
+        result = (result ^ data[i]) * prime;
+    }
+    return static_cast<uint32_t>(result ^ (result >> 32));
+}
+
+// ====== LZ 压缩 ======
+// 字节对齐的 LZ77（类似 LZ4 的序列格式）：
+//   token（高 4 位字面量长度，低 4 位匹配长度 - 4，15 表示后续还有长度字节，每字节累加，255 表示继续）
+//   [字面量长度字节] 字面量 2 字节匹配偏移（小端） [匹配长度字节]
+// 最后一个序列只有字面量，解压按原始大小判断结束
+
+static constexpr uint32_t LZ_MIN_MATCH = 4;
+static constexpr uint32_t LZ_HASH_BITS = 12;
+static constexpr size_t LZ_MAX_OFFSET = 65535;
+
+static inline uint32_t LzRead32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint32_t LzHash(uint32_t value) {
+    return (value * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+// 最坏情况（完全不可压缩）的输出大小
+static inline size_t LzBound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+static uint8_t* LzWriteLength(uint8_t* out, size_t length) {
+    for (length -= 15; length >= 255; length -= 255) {
+        *out++ = 255;
+    }
+    *out++ = static_cast<uint8_t>(length);
+    return out;
+}
+
+// matchLength 为 0 表示最后一个序列（只有字面量）
+static uint8_t* LzWriteSequence(uint8_t* out, const uint8_t* literals, size_t literalLength, size_t matchLength, size_t offset) {
+    uint8_t* token = out++;
+    *token = static_cast<uint8_t>((literalLength < 15 ? literalLength : 15) << 4);
+    if (literalLength >= 15) {
+        out = LzWriteLength(out, literalLength);
+    }
+    memcpy(out, literals, literalLength);
+    out += literalLength;
+
+    if (matchLength > 0) {
+        *out++ = static_cast<uint8_t>(offset);
+        *out++ = static_cast<uint8_t>(offset >> 8);
+        const size_t code = matchLength - LZ_MIN_MATCH;
+        *token |= static_cast<uint8_t>(code < 15 ? code : 15);
+        if (code >= 15) {
+            out = LzWriteLength(out, code);
+        }
+    }
+    return out;
+}
+
+// out 容量至少为 LzBound(size)，返回压缩后的字节数
+static size_t LzCompress(const uint8_t* in, size_t size, uint8_t* out) {
+    uint32_t table[1u << LZ_HASH_BITS];
+    memset(table, 0, sizeof(table));
+
+    const uint8_t* end = in + size;
+    const uint8_t* matchLimit = size >= LZ_MIN_MATCH ? end - LZ_MIN_MATCH : in;
+    const uint8_t* anchor = in;
+    const uint8_t* ip = in;
+    uint8_t* op = out;
+
+    while (ip < matchLimit) {
+        const uint32_t sequence = LzRead32(ip);
+        const uint32_t hash = LzHash(sequence);
+        const uint8_t* ref = in + table[hash];
+        table[hash] = static_cast<uint32_t>(ip - in);
+
+        if (ref >= ip || static_cast<size_t>(ip - ref) > LZ_MAX_OFFSET || LzRead32(ref) != sequence) {
+            // 连续找不到匹配时加大步长，不可压缩的数据很快跳过
+            ip += 1 + ((ip - anchor) >> 6);
+            continue;
+        }
+
+        const uint8_t* matchEnd = ip + LZ_MIN_MATCH;
+        const uint8_t* refEnd = ref + LZ_MIN_MATCH;
+        while (matchEnd < end && *matchEnd == *refEnd) {
+            matchEnd++;
+            refEnd++;
+        }
+
+        op = LzWriteSequence(op, anchor, static_cast<size_t>(ip - anchor), static_cast<size_t>(matchEnd - ip), static_cast<size_t>(ip - ref));
+        ip = matchEnd;
+        anchor = ip;
+    }
+
+    op = LzWriteSequence(op, anchor, static_cast<size_t>(end - anchor), 0, 0);
+    return static_cast<size_t>(op - out);
+}
+
+static bool LzReadLength(const uint8_t*& ip, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (ip >= end) return false;
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+// 解压到恰好 rawSize 字节；数据损坏（越界、偏移无效、长度不符）时返回 false
+static bool LzDecompress(const uint8_t* in, size_t size, uint8_t* out, size_t rawSize) {
+    const uint8_t* ip = in;
+    const uint8_t* end = in + size;
+    uint8_t* op = out;
+    uint8_t* outEnd = out + rawSize;
+
+    while (ip < end) {
+        const uint8_t token = *ip++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !LzReadLength(ip, end, literalLength)) return false;
+        if (literalLength > static_cast<size_t>(end - ip) || literalLength > static_cast<size_t>(outEnd - op)) return false;
+        memcpy(op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        if (ip == end) break;
+
+        if (end - ip < 2) return false;
+        const size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !LzReadLength(ip, end, matchLength)) return false;
+        matchLength += LZ_MIN_MATCH;
+        if (offset == 0 || offset > static_cast<size_t>(op - out) || matchLength > static_cast<size_t>(outEnd - op)) return false;
+
+        // 匹配可能与输出重叠（offset < matchLength），逐字节复制
+        const uint8_t* ref = op - offset;
+        if (offset >= matchLength) {
+            memcpy(op, ref, matchLength);
+            op += matchLength;
+        } else {
+            for (size_t i = 0; i < matchLength; i++) {
+                *op++ = *ref++;
+            }
+        }
+    }
+    return op == outEnd;
+}
+
+// ====== 内存映射文件 ======
+
+struct MappedFile {
+    uint8_t* data;
+    size_t size;
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+};
+
+static void UnmapFile(MappedFile& file) {
+#if defined(_WIN32) || defined(_WIN64)
+    if (file.data) UnmapViewOfFile(file.data);
+    if (file.mapping) CloseHandle(file.mapping);
+    if (file.file != INVALID_HANDLE_VALUE) CloseHandle(file.file);
+    file.mapping = nullptr;
+    file.file = INVALID_HANDLE_VALUE;
+#else
+    if (file.data) munmap(file.data, file.size);
+    if (file.fd >= 0) close(file.fd);
+    file.fd = -1;
+#endif
+    file.data = nullptr;
+    file.size = 0;
+}
+
+// 创建（覆盖）大小为 size 的文件并以共享可写方式映射
+static bool MapFileForWrite(const char* path, size_t size, MappedFile& file) {
+    file.data = nullptr;
+    file.size = size;
+#if defined(_WIN32) || defined(_WIN64)
+    file.mapping = nullptr;
+    file.file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file.file == INVALID_HANDLE_VALUE) return false;
+    // 映射对象大于文件时文件自动扩展
+    file.mapping = CreateFileMappingA(file.file, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<uint64_t>(size) >> 32), static_cast<DWORD>(size), nullptr);
+    if (file.mapping) {
+        file.data = static_cast<uint8_t*>(MapViewOfFile(file.mapping, FILE_MAP_WRITE, 0, 0, size));
+    }
+#else
+    file.fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file.fd < 0) return false;
+    if (ftruncate(file.fd, static_cast<off_t>(size)) == 0) {
+        void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file.fd, 0);
+        file.data = data != MAP_FAILED ? static_cast<uint8_t*>(data) : nullptr;
+    }
+#endif
+    if (!file.data) {
+        UnmapFile(file);
+        return false;
+    }
+    return true;
+}
+
+// 把映射的修改和文件本身刷到磁盘
+static bool FlushMappedFile(MappedFile& file) {
+#if defined(_WIN32) || defined(_WIN64)
+    return FlushViewOfFile(file.data, file.size) != 0 && FlushFileBuffers(file.file) != 0;
+#else
+    return msync(file.data, file.size, MS_SYNC) == 0 && fsync(file.fd) == 0;
+#endif
+}
+
+// 用 from 原子替换 to：已打开 to 的快照继续映射旧文件，不受影响
+static bool ReplaceSnapshotFile(const char* from, const char* to) {
+#if defined(_WIN32) || defined(_WIN64)
+    if (GetFileAttributesA(to) != INVALID_FILE_ATTRIBUTES) {
+        return ReplaceFileA(to, from, nullptr, REPLACEFILE_IGNORE_MERGE_ERRORS, nullptr, nullptr) != 0;
+    }
+    return MoveFileExA(from, to, MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
+
+// 以写时复制的私有方式映射整个文件：可以修改映射内容，但不会写回文件
+static bool MapFileForRead(const char* path, MappedFile& file) {
+    file.data = nullptr;
+    file.size = 0;
+#if defined(_WIN32) || defined(_WIN64)
+    file.mapping = nullptr;
+    // FILE_SHARE_DELETE：打开期间允许保存新快照替换该路径
+    file.file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file.file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(file.file, &fileSize) && fileSize.QuadPart > 0) {
+        file.size = static_cast<size_t>(fileSize.QuadPart);
+        file.mapping = CreateFileMappingA(file.file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (file.mapping) {
+            file.data = static_cast<uint8_t*>(MapViewOfFile(file.mapping, FILE_MAP_COPY, 0, 0, 0));
+        }
+    }
+#else
+    file.fd = open(path, O_RDONLY);
+    if (file.fd < 0) return false;
+    struct stat info;
+    if (fstat(file.fd, &info) == 0 && info.st_size > 0) {
+        file.size = static_cast<size_t>(info.st_size);
+        void* data = mmap(nullptr, file.size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file.fd, 0);
+        file.data = data != MAP_FAILED ? static_cast<uint8_t*>(data) : nullptr;
+    }
+#endif
+    if (!file.data) {
+        UnmapFile(file);
+        return false;
+    }
+#if defined(MADV_WILLNEED)
+    // 分块会被多个线程同时读取，提前让内核预读
+    madvise(file.data, file.size, MADV_WILLNEED);
+#endif
+    return true;
+}
+
+// ====== 分块并行 ======
+
+static void EmptySnapshotJob(Job*, void*) {
+}
+
+// 每个分块一个 Job，调用线程等待时参与执行
+static void RunSnapshotChunks(JobSystem* system, uint32_t chunkCount, ParallelChunkCCallback callback, void* userData) {
+    Job* rootJob = system->CreateJob(EmptySnapshotJob);
+    parallel_for_chunks_c(system, rootJob, chunkCount, 1, callback, userData);
+    system->RunJob(rootJob);
+    system->WaitJob(rootJob);
+}
+
+static inline uint32_t SnapshotChunkCount(uint32_t count) {
+    return (count + SNAPSHOT_CHUNK_PARTICLES - 1) / SNAPSHOT_CHUNK_PARTICLES;
+}
+
+// ====== 保存 ======
+
+struct SnapshotSaveChunk {
+    std::vector<uint8_t> compressed;   // 为空表示按原样存储
+    SnapshotChunk entry;
+};
+
+struct SnapshotSaveContext {
+    const uint8_t* particles;
+    uint8_t* mapped;
+    bool compress;
+    std::vector<SnapshotSaveChunk> chunks;
+};
+
+// 第一遍：压缩（可选）并计算存储字节的校验和
+static void EncodeSnapshotChunk(uint32_t begin, uint32_t end, uint32_t, void* userData) {
+    SnapshotSaveContext* ctx = static_cast<SnapshotSaveContext*>(userData);
+
+    for (uint32_t k = begin; k < end; k++) {
+        SnapshotSaveChunk& chunk = ctx->chunks[k];
+        const uint8_t* raw = ctx->particles + static_cast<size_t>(k) * SNAPSHOT_CHUNK_PARTICLES * sizeof(ParticleData);
+        const size_t rawSize = chunk.entry.rawSize;
+
+        if (ctx->compress) {
+            chunk.compressed.resize(LzBound(rawSize));
+            const size_t compressedSize = LzCompress(raw, rawSize, chunk.compressed.data());
+            if (compressedSize < rawSize) {
+                chunk.compressed.resize(compressedSize);
+            } else {
+                std::vector<uint8_t>().swap(chunk.compressed);
+            }
+        }
+
+        const bool compressed = !chunk.compressed.empty();
+        const uint8_t* stored = compressed ? chunk.compressed.data() : raw;
+        chunk.entry.storedSize = static_cast<uint32_t>(compressed ? chunk.compressed.size() : rawSize);
+        chunk.entry.flags = compressed ? SNAPSHOT_CHUNK_COMPRESSED : 0;
+        chunk.entry.checksum = SnapshotChecksum(stored, chunk.entry.storedSize);
+    }
+}
+
+// 第二遍：各分块写入映射中互不重叠的区间
+static void WriteSnapshotChunk(uint32_t begin, uint32_t end, uint32_t, void* userData) {
+    SnapshotSaveContext* ctx = static_cast<SnapshotSaveContext*>(userData);
+
+    for (uint32_t k = begin; k < end; k++) {
+        SnapshotSaveChunk& chunk = ctx->chunks[k];
+        const uint8_t* stored = chunk.compressed.empty()
+            ? ctx->particles + static_cast<size_t>(k) * SNAPSHOT_CHUNK_PARTICLES * sizeof(ParticleData)
+            : chunk.compressed.data();
+        memcpy(ctx->mapped + chunk.entry.offset, stored, chunk.entry.storedSize);
+        std::vector<uint8_t>().swap(chunk.compressed);
+    }
+}
+
+JOBSYSTEM_C_API int JobSystem_SaveParticleSnapshot(
+    JobSystem* system,
+    const char* path,
+    const ParticleData* particles,
+    uint32_t count,
+    const PhysicsParams* params,
+    uint32_t flags
+) {
+    if (!system || !path || !params || (count > 0 && !particles)) {
+        return PARTICLE_SNAPSHOT_ERROR_ARGUMENT;
+    }
+
+    SnapshotSaveContext ctx;
+    ctx.particles = reinterpret_cast<const uint8_t*>(particles);
+    ctx.mapped = nullptr;
+    ctx.compress = (flags & PARTICLE_SNAPSHOT_COMPRESS) != 0;
+
+    const uint32_t chunkCount = SnapshotChunkCount(count);
+    ctx.chunks.resize(chunkCount);
+    for (uint32_t k = 0; k < chunkCount; k++) {
+        const uint32_t first = k * SNAPSHOT_CHUNK_PARTICLES;
+        const uint32_t n = count - first < SNAPSHOT_CHUNK_PARTICLES ? count - first : SNAPSHOT_CHUNK_PARTICLES;
+        SnapshotChunk& entry = ctx.chunks[k].entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.rawSize = static_cast<uint32_t>(n * sizeof(ParticleData));
+    }
+
+    if (chunkCount > 0) {
+        RunSnapshotChunks(system, chunkCount, EncodeSnapshotChunk, &ctx);
+    }
+
+    // 分块大小确定后排布：未压缩的分块是 sizeof(ParticleData) 的整数倍，首尾相接
+    const uint64_t tableOffset = sizeof(SnapshotHeader) + sizeof(PhysicsParams);
+    const uint64_t dataOffset = AlignUp(tableOffset + static_cast<uint64_t>(chunkCount) * sizeof(SnapshotChunk), SNAPSHOT_DATA_ALIGNMENT);
+    uint64_t offset = dataOffset;
+    for (uint32_t k = 0; k < chunkCount; k++) {
+        offset = AlignUp(offset, SNAPSHOT_CHUNK_ALIGNMENT);
+        ctx.chunks[k].entry.offset = offset;
+        offset += ctx.chunks[k].entry.storedSize;
+    }
+    const uint64_t fileSize = offset;
+    if (fileSize != static_cast<size_t>(fileSize)) {
+        return PARTICLE_SNAPSHOT_ERROR_IO;
+    }
+
+    // 写到临时文件，刷盘后再替换目标：不截断正在被映射的旧快照，中途崩溃也不会留下半个文件
+    const std::string tempPath = std::string(path) + ".tmp";
+    MappedFile file;
+    if (!MapFileForWrite(tempPath.c_str(), static_cast<size_t>(fileSize), file)) {
+        remove(tempPath.c_str());
+        return PARTICLE_SNAPSHOT_ERROR_IO;
+    }
+    ctx.mapped = file.data;
+
+    if (chunkCount > 0) {
+        RunSnapshotChunks(system, chunkCount, WriteSnapshotChunk, &ctx);
+    }
+
+    memcpy(file.data + sizeof(SnapshotHeader), params, sizeof(PhysicsParams));
+    SnapshotChunk* table = reinterpret_cast<SnapshotChunk*>(file.data + tableOffset);
+    for (uint32_t k = 0; k < chunkCount; k++) {
+        table[k] = ctx.chunks[k].entry;
+    }
+
+    // 头部最后写入：替换失败残留的临时文件魔数为 0，打开时报格式错误
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.particleSize = sizeof(ParticleData);
+    header.paramsSize = sizeof(PhysicsParams);
+    header.particleCount = count;
+    header.chunkParticles = SNAPSHOT_CHUNK_PARTICLES;
+    header.chunkCount = chunkCount;
+    header.tableChecksum = SnapshotChecksum(file.data + sizeof(SnapshotHeader), static_cast<size_t>(dataOffset - sizeof(SnapshotHeader)));
+    header.dataOffset = dataOffset;
+    header.fileSize = fileSize;
+    memcpy(file.data, &header, sizeof(header));
+
+    const bool flushed = FlushMappedFile(file);
+    UnmapFile(file);
+    if (!flushed || !ReplaceSnapshotFile(tempPath.c_str(), path)) {
+        remove(tempPath.c_str());
+        return PARTICLE_SNAPSHOT_ERROR_IO;
+    }
+    return PARTICLE_SNAPSHOT_OK;
+}
+
+// ====== 打开 / 恢复 ======
+
+struct ParticleSnapshot {
+    MappedFile file;
+    SnapshotHeader header;
+    const SnapshotChunk* chunks;
+    bool contiguous;           // 所有分块未压缩且首尾相接
+};
+
+// 头部和分块表的一致性检查：之后访问分块数据不会越界
+static int ValidateSnapshot(const ParticleSnapshot* snapshot) {
+    const SnapshotHeader& header = snapshot->header;
+    const uint64_t fileSize = snapshot->file.size;
+
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+        header.headerSize != sizeof(SnapshotHeader) || header.particleSize != sizeof(ParticleData) ||
+        header.paramsSize != sizeof(PhysicsParams) || header.chunkParticles != SNAPSHOT_CHUNK_PARTICLES ||
+        header.chunkCount != SnapshotChunkCount(header.particleCount) || header.fileSize != fileSize) {
+        return PARTICLE_SNAPSHOT_ERROR_FORMAT;
+    }
+
+    const uint64_t tableOffset = sizeof(SnapshotHeader) + sizeof(PhysicsParams);
+    if (header.dataOffset < tableOffset + static_cast<uint64_t>(header.chunkCount) * sizeof(SnapshotChunk) ||
+        header.dataOffset > fileSize) {
+        return PARTICLE_SNAPSHOT_ERROR_FORMAT;
+    }
+    const uint8_t* data = snapshot->file.data;
+    if (SnapshotChecksum(data + sizeof(SnapshotHeader), static_cast<size_t>(header.dataOffset - sizeof(SnapshotHeader))) != header.tableChecksum) {
+        return PARTICLE_SNAPSHOT_ERROR_CHECKSUM;
+    }
+
+    for (uint32_t k = 0; k < header.chunkCount; k++) {
+        const SnapshotChunk& chunk = snapshot->chunks[k];
+        const uint32_t first = k * SNAPSHOT_CHUNK_PARTICLES;
+        const uint32_t n = header.particleCount - first < SNAPSHOT_CHUNK_PARTICLES ? header.particleCount - first : SNAPSHOT_CHUNK_PARTICLES;
+        const bool compressed = (chunk.flags & SNAPSHOT_CHUNK_COMPRESSED) != 0;
+        if (chunk.rawSize != n * sizeof(ParticleData) || (!compressed && chunk.storedSize != chunk.rawSize) ||
+            chunk.offset < header.dataOffset || chunk.offset > fileSize || chunk.storedSize > fileSize - chunk.offset) {
+            return PARTICLE_SNAPSHOT_ERROR_FORMAT;
+        }
+    }
+    return PARTICLE_SNAPSHOT_OK;
+}
+
+JOBSYSTEM_C_API ParticleSnapshot* ParticleSnapshot_Open(const char* path, int* error) {
+    int result = PARTICLE_SNAPSHOT_ERROR_ARGUMENT;
+    ParticleSnapshot* snapshot = nullptr;
+
+    if (path) {
+        snapshot = new (std::nothrow) ParticleSnapshot();
+        result = PARTICLE_SNAPSHOT_ERROR_IO;
+    }
+    if (snapshot && MapFileForRead(path, snapshot->file)) {
+        result = PARTICLE_SNAPSHOT_ERROR_FORMAT;
+        if (snapshot->file.size >= sizeof(SnapshotHeader) + sizeof(PhysicsParams)) {
+            memcpy(&snapshot->header, snapshot->file.data, sizeof(SnapshotHeader));
+            snapshot->chunks = reinterpret_cast<const SnapshotChunk*>(snapshot->file.data + sizeof(SnapshotHeader) + sizeof(PhysicsParams));
+            result = ValidateSnapshot(snapshot);
+        }
+        if (result != PARTICLE_SNAPSHOT_OK) {
+            UnmapFile(snapshot->file);
+        }
+    }
+    if (snapshot && result != PARTICLE_SNAPSHOT_OK) {
+        delete snapshot;
+        snapshot = nullptr;
+    }
+
+    if (snapshot) {
+        // 未压缩的分块首尾相接时，数据区就是完整的 ParticleData 数组
+        snapshot->contiguous = true;
+        for (uint32_t k = 0; k < snapshot->header.chunkCount; k++) {
+            const SnapshotChunk& chunk = snapshot->chunks[k];
+            if ((chunk.flags & SNAPSHOT_CHUNK_COMPRESSED) != 0 ||
+                chunk.offset != snapshot->header.dataOffset + static_cast<uint64_t>(k) * SNAPSHOT_CHUNK_PARTICLES * sizeof(ParticleData)) {
+                snapshot->contiguous = false;
+                break;
+            }
+        }
+    }
+
+    if (error) *error = result;
+    return snapshot;
+}
+
+JOBSYSTEM_C_API void ParticleSnapshot_Close(ParticleSnapshot* snapshot) {
+    if (!snapshot) return;
+
+    UnmapFile(snapshot->file);
+    delete snapshot;
+}
+
+JOBSYSTEM_C_API uint32_t ParticleSnapshot_GetCount(const ParticleSnapshot* snapshot) {
+    return snapshot ? snapshot->header.particleCount : 0;
+}
+
+JOBSYSTEM_C_API void ParticleSnapshot_GetParams(const ParticleSnapshot* snapshot, PhysicsParams* params) {
+    if (snapshot && params) {
+        memcpy(params, snapshot->file.data + sizeof(SnapshotHeader), sizeof(PhysicsParams));
+    }
+}
+
+JOBSYSTEM_C_API ParticleData* ParticleSnapshot_MapParticles(ParticleSnapshot* snapshot) {
+    if (!snapshot || !snapshot->contiguous) return nullptr;
+    return reinterpret_cast<ParticleData*>(snapshot->file.data + snapshot->header.dataOffset);
+}
+
+struct SnapshotLoadContext {
+    const ParticleSnapshot* snapshot;
+    uint8_t* particles;        // 为空时只校验
+    std::atomic<int> result;
+};
+
+static void LoadSnapshotChunk(uint32_t begin, uint32_t end, uint32_t, void* userData) {
+    SnapshotLoadContext* ctx = static_cast<SnapshotLoadContext*>(userData);
+    const uint8_t* data = ctx->snapshot->file.data;
+
+    for (uint32_t k = begin; k < end; k++) {
+        const SnapshotChunk& chunk = ctx->snapshot->chunks[k];
+        const uint8_t* stored = data + chunk.offset;
+        bool ok = SnapshotChecksum(stored, chunk.storedSize) == chunk.checksum;
+
+        if (ok && ctx->particles) {
+            uint8_t* out = ctx->particles + static_cast<size_t>(k) * SNAPSHOT_CHUNK_PARTICLES * sizeof(ParticleData);
+            if ((chunk.flags & SNAPSHOT_CHUNK_COMPRESSED) != 0) {
+                ok = LzDecompress(stored, chunk.storedSize, out, chunk.rawSize);
+            } else {
+                memcpy(out, stored, chunk.rawSize);
+            }
+        }
+        if (!ok) {
+            ctx->result.store(PARTICLE_SNAPSHOT_ERROR_CHECKSUM, std::memory_order_relaxed);
+        }
+    }
+}
+
+static int LoadSnapshot(JobSystem* system, const ParticleSnapshot* snapshot, ParticleData* particles) {
+    SnapshotLoadContext ctx;
+    ctx.snapshot = snapshot;
+    ctx.particles = reinterpret_cast<uint8_t*>(particles);
+    ctx.result.store(PARTICLE_SNAPSHOT_OK, std::memory_order_relaxed);
+
+    if (snapshot->header.chunkCount > 0) {
+        RunSnapshotChunks(system, snapshot->header.chunkCount, LoadSnapshotChunk, &ctx);
+    }
+    return ctx.result.load(std::memory_order_relaxed);
+}
+
+JOBSYSTEM_C_API int JobSystem_VerifyParticleSnapshot(JobSystem* system, const ParticleSnapshot* snapshot) {
+    if (!system || !snapshot) return PARTICLE_SNAPSHOT_ERROR_ARGUMENT;
+    return LoadSnapshot(system, snapshot, nullptr);
+}
+
+JOBSYSTEM_C_API int JobSystem_RestoreParticleSnapshot(
+    JobSystem* system,
+    const ParticleSnapshot* snapshot,
+    ParticleData* particles,
+    uint32_t capacity
+) {
+    if (!system || !snapshot || (!particles && snapshot->header.particleCount > 0)) {
+        return PARTICLE_SNAPSHOT_ERROR_ARGUMENT;
+    }
+    if (capacity < snapshot->header.particleCount) {
+        return PARTICLE_SNAPSHOT_ERROR_CAPACITY;
+    }
+    return LoadSnapshot(system, snapshot, particles);
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include "JobSystemCAPI.h"
+#include "ParticleUpdateNative.h"
+
+// 粒子快照：把 ParticleData 数组和 PhysicsParams 存为分块二进制文件，用于回放和快速重载关卡
+//
+// 文件格式（小端，本机结构体布局）：
+//   头部（魔数、版本、ParticleData / PhysicsParams 大小、粒子数量、分块表位置）
+//   PhysicsParams
+//   分块表：每块的文件偏移、存储大小、原始大小、校验和、是否压缩
+//   分块数据：从页边界开始；未压缩的分块首尾相接，正好是连续的 ParticleData 数组
+//
+// 读写都通过内存映射文件，由 Job 按分块并行完成（压缩、校验、拷贝）
+// 布局一致且没有压缩的分块时，可以直接映射为 ParticleData 数组，不拷贝
+
+typedef struct ParticleSnapshot ParticleSnapshot;
+
+// 保存选项
+typedef enum ParticleSnapshotFlags {
+    PARTICLE_SNAPSHOT_COMPRESS = 1 << 0     // 分块 LZ 压缩（压缩后不变小的分块仍按原样存储）
+} ParticleSnapshotFlags;
+
+// 返回码
+typedef enum ParticleSnapshotResult {
+    PARTICLE_SNAPSHOT_OK = 0,
+    PARTICLE_SNAPSHOT_ERROR_IO = -1,        // 文件无法创建 / 打开 / 映射
+    PARTICLE_SNAPSHOT_ERROR_FORMAT = -2,    // 不是快照文件，或版本 / 结构体布局不一致
+    PARTICLE_SNAPSHOT_ERROR_CHECKSUM = -3,  // 数据校验失败或压缩数据损坏
+    PARTICLE_SNAPSHOT_ERROR_CAPACITY = -4,  // 输出数组容量不足
+    PARTICLE_SNAPSHOT_ERROR_ARGUMENT = -5   // 参数为空
+} ParticleSnapshotResult;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 保存粒子快照（阻塞直到文件写完，期间调用线程参与执行分块 Job）
+ * system: JobSystem 实例指针（需在主线程或 Job 中调用）
+ * path: 文件路径；先写入 path.tmp 并刷到磁盘，再原子替换 path（已存在时覆盖）
+ *       已打开的旧快照继续映射旧文件；失败时 path 保持原样
+ * particles/count: 粒子数组
+ * params: 物理参数
+ * flags: ParticleSnapshotFlags 组合
+ * 返回: ParticleSnapshotResult
+ */
+JOBSYSTEM_C_API int JobSystem_SaveParticleSnapshot(
+    JobSystem* system,
+    const char* path,
+    const ParticleData* particles,
+    uint32_t count,
+    const PhysicsParams* params,
+    uint32_t flags
+);
+
+/**
+ * 打开快照：映射文件并校验头部和分块表（不读取分块数据）
+ * error: 可选输出错误码
+ * 返回: 快照指针，用 ParticleSnapshot_Close 关闭；失败返回 NULL
+ */
+JOBSYSTEM_C_API ParticleSnapshot* ParticleSnapshot_Open(const char* path, int* error);
+
+/**
+ * 关闭快照（ParticleSnapshot_MapParticles 返回的指针随之失效）
+ */
+JOBSYSTEM_C_API void ParticleSnapshot_Close(ParticleSnapshot* snapshot);
+
+/**
+ * 获取粒子数量
+ */
+JOBSYSTEM_C_API uint32_t ParticleSnapshot_GetCount(const ParticleSnapshot* snapshot);
+
+/**
+ * 获取保存时的物理参数
+ */
+JOBSYSTEM_C_API void ParticleSnapshot_GetParams(const ParticleSnapshot* snapshot, PhysicsParams* params);
+
+/**
+ * 零拷贝访问：所有分块都未压缩时返回映射中的粒子数组，否则返回 NULL
+ * 映射是写时复制的私有映射：可以直接在其上更新粒子，修改不会写回文件
+ * 页面在首次访问时才从文件读入；不校验数据，需要时先调用 JobSystem_VerifyParticleSnapshot
+ */
+JOBSYSTEM_C_API ParticleData* ParticleSnapshot_MapParticles(ParticleSnapshot* snapshot);
+
+/**
+ * 并行校验所有分块的校验和
+ * 返回: PARTICLE_SNAPSHOT_OK 或 PARTICLE_SNAPSHOT_ERROR_CHECKSUM
+ */
+JOBSYSTEM_C_API int JobSystem_VerifyParticleSnapshot(JobSystem* system, const ParticleSnapshot* snapshot);
+
+/**
+ * 并行恢复粒子：每个分块校验后解压或拷贝到 particles
+ * capacity: particles 数组容量，需 >= ParticleSnapshot_GetCount
+ * 返回: PARTICLE_SNAPSHOT_OK 或错误码（校验失败时 particles 内容不确定）
+ */
+JOBSYSTEM_C_API int JobSystem_RestoreParticleSnapshot(
+    JobSystem* system,
+    const ParticleSnapshot* snapshot,
+    ParticleData* particles,
+    uint32_t capacity
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,27 @@
 #include "ParticleUpdateNative.h"
-#include <cmath>
+#include "JobSystem.h"
+#include "ParallelForC.h"
+#include "ParticleSimd.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <vector>
+
+// 更新单个粒子（年龄、死亡重生、积分）
+static inline void UpdateParticle(ParticleData& particle, const PhysicsParams& params, uint32_t seed) {
+    // 1. 更新年龄
+    particle.age += params.deltaTime;
+
+    // 2. 如果粒子死亡，重置粒子
+    if (particle.age >= particle.lifetime) {
+        // 创建线程安全的随机数生成器
+        SimpleRandom rng(seed);
+        SpawnParticle(particle, rng);
+    }
+
+    // 3. 重力、阻尼、位置更新和地面反弹
+    IntegrateParticle(particle, params);
+}
 
 // 纯C++实现的粒子更新逻辑
 // ✅ 零跨界开销 - 可以从任意线程直接调用
@@ -12,43 +34,310 @@ extern "C" void UpdateParticlesNative(
     uintptr_t ptrOffset = reinterpret_cast<uintptr_t>(particles) / sizeof(ParticleData);
 
     for (uint32_t i = 0; i < count; i++) {
-        // 创建线程安全的随机数生成器
-        SimpleRandom rng(params->baseSeed + ptrOffset + i);
+        UpdateParticle(particles[i], *params, static_cast<uint32_t>(params->baseSeed + ptrOffset + i));
+    }
+}
+
+// ====== 渲染实例数据输出 ======
+
+static_assert(sizeof(ParticleInstanceData) == 16, "ParticleInstanceData must stay 16 bytes for streaming stores");
+
+// float -> half（截断尾数，溢出饱和为 Inf，非规格化数刷为 0）
+static inline uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFFu) - 127 + 15;
+    const uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (exponent <= 0) {
+        return static_cast<uint16_t>(sign);
+    }
+    if (exponent >= 31) {
+        // Inf/NaN 保留 NaN，其余饱和为 Inf
+        const bool isNaN = ((bits >> 23) & 0xFFu) == 0xFFu && mantissa != 0;
+        return static_cast<uint16_t>(sign | 0x7C00u | (isNaN ? 0x200u : 0u));
+    }
+    return static_cast<uint16_t>(sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13));
+}
+
+static inline uint32_t PackUnorm8(float value) {
+    value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+    return static_cast<uint32_t>(value * 255.0f + 0.5f);
+}
+
+static inline uint16_t PackUnorm16(float value) {
+    value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+    return static_cast<uint16_t>(value * 65535.0f + 0.5f);
+}
+
+static inline ParticleInstanceData PackInstance(const ParticleData& particle, uint32_t index) {
+    ParticleInstanceData instance;
+    instance.position[0] = FloatToHalf(particle.position.x);
+    instance.position[1] = FloatToHalf(particle.position.y);
+    instance.position[2] = FloatToHalf(particle.position.z);
+    instance.age = PackUnorm16(particle.lifetime > 0.0f ? particle.age / particle.lifetime : 1.0f);
+    instance.color = PackUnorm8(particle.color.r) |
+                     (PackUnorm8(particle.color.g) << 8) |
+                     (PackUnorm8(particle.color.b) << 16) |
+                     (PackUnorm8(particle.color.a) << 24);
+    instance.index = index;
+    return instance;
+}
 
-        // 读取当前粒子
+extern "C" void UpdateParticlesWithOutputNative(
+    ParticleData* particles,
+    uint32_t count,
+    const ParticleUpdateContext* ctx
+) {
+    const PhysicsParams& params = *ctx->params;
+    const uint32_t base = static_cast<uint32_t>(particles - ctx->particles);
+    const uintptr_t ptrOffset = reinterpret_cast<uintptr_t>(particles) / sizeof(ParticleData);
+
+    if (ctx->fields && ctx->fieldCount > 0) {
+        ApplyForceFieldsNative(particles, count, ctx->fields, ctx->fieldCount, params.deltaTime);
+    }
+
+    if (!ctx->instances) {
+        for (uint32_t i = 0; i < count; i++) {
+            UpdateParticle(particles[i], params, static_cast<uint32_t>(params.baseSeed + ptrOffset + i));
+        }
+        return;
+    }
+
+    ParticleInstanceData* out = ctx->instances + base;
+
+#ifdef PARTICLE_SIMD_SSE2
+    // 输出缓冲只写不读：16 字节对齐时绕过缓存直接写内存
+    const bool streaming = (reinterpret_cast<uintptr_t>(out) & 15u) == 0;
+#endif
+
+    for (uint32_t i = 0; i < count; i++) {
         ParticleData& particle = particles[i];
+        UpdateParticle(particle, params, static_cast<uint32_t>(params.baseSeed + ptrOffset + i));
+
+        const ParticleInstanceData instance = PackInstance(particle, base + i);
+#ifdef PARTICLE_SIMD_SSE2
+        if (streaming) {
+            __m128i packed;
+            memcpy(&packed, &instance, sizeof(packed));
+            _mm_stream_si128(reinterpret_cast<__m128i*>(out + i), packed);
+            continue;
+        }
+#endif
+        out[i] = instance;
+    }
+
+#ifdef PARTICLE_SIMD_SSE2
+    // non-temporal 写入是弱序的，Job 结束前必须 fence，保证其他线程可见
+    if (streaming) {
+        _mm_sfence();
+    }
+#endif
+}
+
+// ====== 视锥剔除 + LOD 分级 ======
+
+static constexpr uint32_t DEFAULT_CULL_BATCH_SIZE = 4096;
+// 融合模式下每次更新再剔除的子块大小（64 个粒子 = 4KB，保证剔除时仍在 L1 中）
+static constexpr uint32_t CULL_SUB_BLOCK_SIZE = 64;
+
+struct ParticleCullContext {
+    JobSystem* jobSystem;
+    ParticleData* particles;
+    uint32_t count;
+    uint32_t batchSize;
+    uint32_t chunkCount;
+    bool update;
+    PhysicsParams params;
+    ParticleCullParams cull;
+    ParticleCullOutput* output;
+    std::vector<uint32_t> chunkLodCounts;   // chunkCount * PARTICLE_MAX_LOD
+};
+
+static void EmptyCullJob(Job*, void*) {
+}
+
+// 剔除 [begin, end)，可见粒子按 LOD 追加到 out[lod]
+static void CullRange(const ParticleCullContext* ctx, uint32_t begin, uint32_t end,
+                      uint32_t* const* out, uint32_t* outCounts) {
+    const ParticleCullParams& cull = ctx->cull;
+    const ParticleData* particles = ctx->particles;
+    const uint32_t thresholdCount = cull.lodCount - 1;
+
+    float lodDistanceSq[PARTICLE_MAX_LOD - 1];
+    for (uint32_t t = 0; t < thresholdCount; t++) {
+        lodDistanceSq[t] = cull.lodDistances[t] * cull.lodDistances[t];
+    }
+
+    uint32_t i = begin;
+
+#ifdef PARTICLE_SIMD_SSE2
+    // 一次测试 4 个粒子：AoS 位置转为 SoA 寄存器
+    const __m128 negRadius = _mm_set1_ps(-cull.radius);
+    const __m128 camX = _mm_set1_ps(cull.cameraPosition.x);
+    const __m128 camY = _mm_set1_ps(cull.cameraPosition.y);
+    const __m128 camZ = _mm_set1_ps(cull.cameraPosition.z);
 
-        // 1. 更新年龄
-        particle.age += params->deltaTime;
+    for (; i + 4 <= end; i += 4) {
+        const ParticleData* p = particles + i;
+        const __m128 x = _mm_setr_ps(p[0].position.x, p[1].position.x, p[2].position.x, p[3].position.x);
+        const __m128 y = _mm_setr_ps(p[0].position.y, p[1].position.y, p[2].position.y, p[3].position.y);
+        const __m128 z = _mm_setr_ps(p[0].position.z, p[1].position.z, p[2].position.z, p[3].position.z);
 
-        // 2. 如果粒子死亡，重置粒子
-        if (particle.age >= particle.lifetime) {
-            particle.age = 0.0f;
-            particle.position = float3(
-                rng.NextFloat(-10.0f, 10.0f),
-                rng.NextFloat(5.0f, 10.0f),
-                rng.NextFloat(-10.0f, 10.0f)
-            );
-            particle.velocity = float3(
-                rng.NextFloat(-2.0f, 2.0f),
-                rng.NextFloat(-2.0f, 2.0f),
-                rng.NextFloat(-2.0f, 2.0f)
-            );
+        __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int plane = 0; plane < 6; plane++) {
+            const float* pl = cull.planes[plane];
+            __m128 d = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(pl[0]), x), _mm_mul_ps(_mm_set1_ps(pl[1]), y));
+            d = _mm_add_ps(d, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(pl[2]), z), _mm_set1_ps(pl[3])));
+            visible = _mm_and_ps(visible, _mm_cmpge_ps(d, negRadius));
         }
 
-        // 3. 应用重力
-        particle.velocity += params->gravity * params->deltaTime;
+        const int mask = _mm_movemask_ps(visible);
+        if (mask == 0) continue;
 
-        // 4. 应用阻尼（空气阻力）
-        particle.velocity *= (1.0f - params->damping * params->deltaTime);
+        const __m128 dx = _mm_sub_ps(x, camX);
+        const __m128 dy = _mm_sub_ps(y, camY);
+        const __m128 dz = _mm_sub_ps(z, camZ);
+        const __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
 
-        // 5. 更新位置
-        particle.position += particle.velocity * params->deltaTime;
+        // 比较结果为 -1，累减得到超过的阈值个数即 LOD 级别
+        __m128i lod = _mm_setzero_si128();
+        for (uint32_t t = 0; t < thresholdCount; t++) {
+            lod = _mm_sub_epi32(lod, _mm_castps_si128(_mm_cmpgt_ps(distSq, _mm_set1_ps(lodDistanceSq[t]))));
+        }
+
+        alignas(16) int32_t lods[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lods), lod);
+        for (int k = 0; k < 4; k++) {
+            if (mask & (1 << k)) {
+                const uint32_t l = static_cast<uint32_t>(lods[k]);
+                out[l][outCounts[l]++] = i + k;
+            }
+        }
+    }
+#endif
+
+    for (; i < end; i++) {
+        const float3& p = particles[i].position;
 
-        // 6. 地面碰撞检测和反弹
-        if (particle.position.y < params->groundLevel) {
-            particle.position.y = params->groundLevel;
-            particle.velocity.y = std::abs(particle.velocity.y) * params->bounceCoefficient;
+        bool visible = true;
+        for (int plane = 0; plane < 6 && visible; plane++) {
+            const float* pl = cull.planes[plane];
+            visible = pl[0] * p.x + pl[1] * p.y + pl[2] * p.z + pl[3] >= -cull.radius;
         }
+        if (!visible) continue;
+
+        const float dx = p.x - cull.cameraPosition.x;
+        const float dy = p.y - cull.cameraPosition.y;
+        const float dz = p.z - cull.cameraPosition.z;
+        const float distSq = dx * dx + dy * dy + dz * dz;
+
+        uint32_t l = 0;
+        for (uint32_t t = 0; t < thresholdCount; t++) {
+            l += distSq > lodDistanceSq[t] ? 1u : 0u;
+        }
+        out[l][outCounts[l]++] = i;
+    }
+}
+
+// 分块叶子：可见索引写入本块在输出列表中的区间 [begin, end)
+static void CullChunk(uint32_t begin, uint32_t end, uint32_t chunkIndex, void* userData) {
+    ParticleCullContext* ctx = static_cast<ParticleCullContext*>(userData);
+
+    uint32_t* out[PARTICLE_MAX_LOD];
+    uint32_t outCounts[PARTICLE_MAX_LOD] = {};
+    for (uint32_t l = 0; l < ctx->cull.lodCount; l++) {
+        out[l] = ctx->output->lodIndices[l] + begin;
+    }
+
+    for (uint32_t sub = begin; sub < end; sub += CULL_SUB_BLOCK_SIZE) {
+        const uint32_t subEnd = std::min(end, sub + CULL_SUB_BLOCK_SIZE);
+        if (ctx->update) {
+            UpdateParticlesNative(ctx->particles + sub, subEnd - sub, &ctx->params);
+        }
+        CullRange(ctx, sub, subEnd, out, outCounts);
+    }
+
+    uint32_t* counts = &ctx->chunkLodCounts[chunkIndex * PARTICLE_MAX_LOD];
+    for (uint32_t l = 0; l < PARTICLE_MAX_LOD; l++) {
+        counts[l] = outCounts[l];
     }
 }
+
+// 合并 Job：按分块顺序把各区间压缩到列表开头（目标总在源之前，memmove 安全）
+static void MergeCullJob(Job*, void* data) {
+    ParticleCullContext* ctx = static_cast<ParticleCullContext*>(data);
+    ParticleCullOutput* output = ctx->output;
+
+    for (uint32_t l = 0; l < PARTICLE_MAX_LOD; l++) {
+        if (l >= ctx->cull.lodCount) {
+            output->lodCounts[l] = 0;
+            continue;
+        }
+
+        uint32_t* list = output->lodIndices[l];
+        uint32_t dst = 0;
+        for (uint32_t k = 0; k < ctx->chunkCount; k++) {
+            const uint32_t n = ctx->chunkLodCounts[k * PARTICLE_MAX_LOD + l];
+            const uint32_t src = k * ctx->batchSize;
+            if (n > 0 && src != dst) {
+                memmove(list + dst, list + src, n * sizeof(uint32_t));
+            }
+            dst += n;
+        }
+        output->lodCounts[l] = dst;
+    }
+
+    delete ctx;
+}
+
+JOBSYSTEM_C_API Job* JobSystem_CullParticles(
+    JobSystem* system,
+    ParticleData* particles,
+    uint32_t count,
+    const PhysicsParams* params,
+    const ParticleCullParams* cull,
+    ParticleCullOutput* output,
+    uint32_t threshold
+) {
+    if (!system || !particles || !cull || !output || count == 0 ||
+        cull->lodCount == 0 || cull->lodCount > PARTICLE_MAX_LOD) {
+        return nullptr;
+    }
+    for (uint32_t l = 0; l < cull->lodCount; l++) {
+        if (!output->lodIndices[l]) return nullptr;
+    }
+
+    ParticleCullContext* ctx = new (std::nothrow) ParticleCullContext();
+    if (!ctx) return nullptr;
+
+    ctx->jobSystem = system;
+    ctx->particles = particles;
+    ctx->count = count;
+    ctx->batchSize = threshold > 0 ? threshold : DEFAULT_CULL_BATCH_SIZE;
+    ctx->chunkCount = parallel_chunk_count_c(count, ctx->batchSize);
+    ctx->update = params != nullptr;
+    if (params) {
+        ctx->params = *params;
+    }
+    ctx->cull = *cull;
+    ctx->output = output;
+    ctx->chunkLodCounts.assign(ctx->chunkCount * PARTICLE_MAX_LOD, 0);
+
+    // 与粒子池相同的结构：rootJob 由调用方运行，mergeJob 和 cullJob 是其子 Job
+    Job* rootJob = system->CreateJob(EmptyCullJob);
+    Job* mergeJob = system->CreateJob(rootJob, MergeCullJob);
+    mergeJob->data = ctx;
+    // 合并 Job 负责释放 ctx，rootJob 被取消时也必须运行
+    mergeJob->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
+
+    Job* cullJob = system->CreateJob(rootJob, EmptyCullJob);
+    system->AddContinuation(cullJob, mergeJob);
+
+    parallel_for_chunks_c(system, cullJob, count, ctx->batchSize, CullChunk, ctx);
+    system->RunJob(cullJob);
+
+    return rootJob;
+}
@@ -1,5 +1,7 @@
 #pragma once
+#include "JobSystemCAPI.h"
 #include <cstdint>
+#include <cmath>
 
 // C++版本的 Vector3 (与Unity Vector3兼容)
 struct float3 {
@@ -53,6 +55,56 @@ struct PhysicsParams {
     float groundLevel;
     float bounceCoefficient;
     uint32_t baseSeed;
+    float emitRate;          // 发射速率（粒子/秒），仅 ParticlePool 使用
+    float cellSize;          // 空间哈希网格单元尺寸（小于 2 * particleRadius 时按 2 * particleRadius）
+    float particleRadius;    // 粒子碰撞半径
+    float collisionStiffness; // 穿透修正比例 [0, 1]
+};
+
+// 力场类型
+enum ForceFieldType : uint32_t {
+    FORCE_FIELD_ATTRACTOR = 0,   // 点吸引子（strength < 0 为排斥）
+    FORCE_FIELD_VORTEX = 1,      // 绕 axis 旋转的漩涡
+    FORCE_FIELD_TURBULENCE = 2,  // 平铺 curl-noise 湍流（无散度）
+    FORCE_FIELD_WIND = 3,        // 盒状风场，盒内沿 axis 施加恒定加速度
+};
+
+// 力场描述
+struct ForceField {
+    uint32_t type;           // ForceFieldType
+    float strength;          // 加速度强度
+    float radius;            // 影响半径，线性衰减到 0（<= 0 表示不衰减；风场不使用）
+    float frequency;         // 湍流采样频率（每单位长度的噪声周期数）
+    float3 center;           // 吸引子/漩涡/湍流衰减中心，风场盒中心
+    float3 axis;             // 漩涡轴 / 风向（单位向量）
+    float3 extents;          // 风场盒半尺寸
+    float _padding;
+};
+
+// 打包后的渲染实例数据（16 字节，可直接作为 GPU 实例缓冲）
+struct ParticleInstanceData {
+    uint16_t position[3];    // half float 位置
+    uint16_t age;            // 归一化年龄 age / lifetime（unorm16）
+    uint32_t color;          // RGBA8，R 在最低字节
+    uint32_t index;          // 源粒子索引
+};
+
+// 剔除支持的最大 LOD 级数
+static constexpr uint32_t PARTICLE_MAX_LOD = 4;
+
+// 视锥剔除 + LOD 分级参数
+struct ParticleCullParams {
+    float planes[6][4];                            // 视锥平面 (nx, ny, nz, d)，dot(n, p) + d >= 0 为内侧
+    float3 cameraPosition;
+    float radius;                                  // 粒子包围球半径
+    uint32_t lodCount;                             // LOD 级数 [1, PARTICLE_MAX_LOD]
+    float lodDistances[PARTICLE_MAX_LOD - 1];      // 升序距离阈值：距离 <= lodDistances[0] 为 LOD0，依此类推
+};
+
+// 剔除输出：每级 LOD 一个可见索引列表（由调用方分配，容量 >= 粒子数量）
+struct ParticleCullOutput {
+    uint32_t* lodIndices[PARTICLE_MAX_LOD];
+    uint32_t lodCounts[PARTICLE_MAX_LOD];          // 输出：每级可见数量
 };
 
 // 简单的线性同余随机数生成器 (与Unity Mathematics.Random兼容)
@@ -77,9 +129,98 @@ public:
     }
 };
 
+// 重生粒子：随机位置和速度，年龄归零
+inline void SpawnParticle(ParticleData& particle, SimpleRandom& rng) {
+    particle.age = 0.0f;
+    particle.position = float3(
+        rng.NextFloat(-10.0f, 10.0f),
+        rng.NextFloat(5.0f, 10.0f),
+        rng.NextFloat(-10.0f, 10.0f)
+    );
+    particle.velocity = float3(
+        rng.NextFloat(-2.0f, 2.0f),
+        rng.NextFloat(-2.0f, 2.0f),
+        rng.NextFloat(-2.0f, 2.0f)
+    );
+}
+
+// 积分一个存活粒子：重力、阻尼、位置更新、地面反弹
+inline void IntegrateParticle(ParticleData& particle, const PhysicsParams& params) {
+    // 1. 应用重力
+    particle.velocity += params.gravity * params.deltaTime;
+
+    // 2. 应用阻尼（空气阻力）
+    particle.velocity *= (1.0f - params.damping * params.deltaTime);
+
+    // 3. 更新位置
+    particle.position += particle.velocity * params.deltaTime;
+
+    // 4. 地面碰撞检测和反弹
+    if (particle.position.y < params.groundLevel) {
+        particle.position.y = params.groundLevel;
+        particle.velocity.y = std::abs(particle.velocity.y) * params.bounceCoefficient;
+    }
+}
+
 // 纯C++粒子更新函数 (零C# delegate开销)
 extern "C" void UpdateParticlesNative(
     ParticleData* particles,
     uint32_t count,
     const PhysicsParams* params
 );
+
+/**
+ * 对粒子叠加力场加速度：velocity += sum(field(position)) * deltaTime
+ * 每 4 个粒子一组，用 SIMD 依次计算每个力场
+ */
+extern "C" void ApplyForceFieldsNative(
+    ParticleData* particles,
+    uint32_t count,
+    const ForceField* fields,
+    uint32_t fieldCount,
+    float deltaTime
+);
+
+// 扩展粒子更新上下文（作为 JobSystem_ParallelForNative 的 userData）
+struct ParticleUpdateContext {
+    const PhysicsParams* params;
+    ParticleData* particles;             // 粒子数组起始地址，用于计算输出下标
+    ParticleInstanceData* instances;     // 可选输出缓冲（容量 >= 粒子数量，NULL 表示不输出）
+    const ForceField* fields;            // 可选力场数组（NULL 表示无力场）
+    uint32_t fieldCount;
+};
+
+/**
+ * 扩展的粒子更新（NativeCallback 兼容签名）
+ * 先按 4 个粒子一组用 SIMD 叠加所有力场加速度，再执行与 UpdateParticlesNative 相同的更新，
+ * 并可在同一遍历中写出打包的实例数据
+ * 实例数据写入 ctx->instances[粒子下标]；缓冲 16 字节对齐时使用 non-temporal 写入，
+ * 不污染缓存（适合 Unity NativeArray 或映射的上传缓冲）
+ * particles 必须是 ctx->particles 的子区间
+ */
+extern "C" void UpdateParticlesWithOutputNative(
+    ParticleData* particles,
+    uint32_t count,
+    const ParticleUpdateContext* ctx
+);
+
+/**
+ * 并行视锥剔除 + LOD 分级（可选与粒子更新融合为同一次遍历）
+ * system: JobSystem 实例指针
+ * particles: 粒子数组
+ * count: 粒子数量
+ * params: 物理参数；非 NULL 时每个分块先更新再剔除（数据仍在缓存中），NULL 时只剔除
+ * cull: 剔除参数（会被拷贝）
+ * output: 输出列表；各分块先写入自己的区间，合并 Job 再无锁压缩
+ * threshold: 每个分块的粒子数量（0 使用默认值 4096）
+ * 返回: 根 Job 指针，调用方需 RunJob + WaitJob；完成后 output->lodCounts 有效
+ */
+JOBSYSTEM_C_API Job* JobSystem_CullParticles(
+    JobSystem* system,
+    ParticleData* particles,
+    uint32_t count,
+    const PhysicsParams* params,
+    const ParticleCullParams* cull,
+    ParticleCullOutput* output,
+    uint32_t threshold
+);
@@ -0,0 +1,83 @@
+#include "ScratchArena.h"
+#include <cstdlib>
+
+ScratchArena::~ScratchArena()
+{
+	Block* block = head;
+	while (block) {
+		Block* next = block->next;
+		free(block);
+		block = next;
+	}
+	head = current = nullptr;
+	reservedBytes = 0;
+}
+
+ScratchArena::Block* ScratchArena::NewBlock(size_t minSize)
+{
+	const size_t size = minSize > DEFAULT_BLOCK_SIZE ? minSize : DEFAULT_BLOCK_SIZE;
+	Block* block = static_cast<Block*>(malloc(sizeof(Block) + size));
+	if (!block) return nullptr;
+
+	block->next = nullptr;
+	block->size = size;
+	block->used = 0;
+	reservedBytes += size;
+	return block;
+}
+
+void* ScratchArena::Allocate(size_t size, size_t alignment)
+{
+	if (alignment == 0) alignment = 1;
+
+	if (current) {
+		const uintptr_t base = reinterpret_cast<uintptr_t>(BlockData(current));
+		const uintptr_t aligned = (base + current->used + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		const size_t end = (aligned - base) + size;
+		if (end <= current->size) {
+			current->used = end;
+			return reinterpret_cast<void*>(aligned);
+		}
+	}
+
+	// 当前块放不下：优先复用后续已有块，否则在当前块之后插入新块
+	const size_t needed = size + alignment;
+	Block* next = current ? current->next : head;
+	if (!next || next->size < needed) {
+		Block* block = NewBlock(needed);
+		if (!block) return nullptr;
+		block->next = next;
+		if (current) current->next = block;
+		else head = block;
+		next = block;
+	}
+
+	current = next;
+	current->used = 0;
+
+	const uintptr_t base = reinterpret_cast<uintptr_t>(BlockData(current));
+	const uintptr_t aligned = (base + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	current->used = (aligned - base) + size;
+	return reinterpret_cast<void*>(aligned);
+}
+
+ScratchArena::Marker ScratchArena::GetMarker() const
+{
+	Marker marker;
+	marker.block = current;
+	marker.used = current ? current->used : 0;
+	return marker;
+}
+
+void ScratchArena::Reset(const Marker& marker)
+{
+	current = static_cast<Block*>(marker.block);
+	if (current) {
+		current->used = marker.used;
+	}
+}
+
+void ScratchArena::Reset()
+{
+	current = nullptr;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// 线程私有的线性（bump）分配器，用于 Job 内的临时缓冲
+// 按块增长，Reset 只回退指针不释放内存，之后的分配复用已有块
+class ScratchArena {
+public:
+	static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+	// 回退点：Reset(marker) 释放 marker 之后的所有分配
+	struct Marker {
+		void* block;
+		size_t used;
+	};
+
+	ScratchArena() : head(nullptr), current(nullptr), reservedBytes(0) {}
+	~ScratchArena();
+
+	// alignment 必须是 2 的幂
+	void* Allocate(size_t size, size_t alignment = 16);
+	Marker GetMarker() const;
+	void Reset(const Marker& marker);
+	void Reset();
+	size_t GetReservedBytes() const { return reservedBytes; }
+
+private:
+	struct Block {
+		Block* next;
+		size_t size;       // 数据区字节数
+		size_t used;
+	};
+
+	static char* BlockData(Block* block) { return reinterpret_cast<char*>(block + 1); }
+	Block* NewBlock(size_t minSize);
+
+	Block* head;
+	Block* current;
+	size_t reservedBytes;
+
+	ScratchArena(const ScratchArena&) = delete;
+	ScratchArena& operator=(const ScratchArena&) = delete;
+};
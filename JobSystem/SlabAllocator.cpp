@@ -0,0 +1,283 @@
+#include "SlabAllocator.h"
+#include <cassert>
+#include <cstdlib>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+static constexpr uintptr_t SLAB_MASK = ~(static_cast<uintptr_t>(SlabAllocator::SLAB_SIZE) - 1);
+static constexpr uint32_t SLAB_HEADER_SIZE = 64;   // 头部独占一条缓存行
+static constexpr uint32_t SLAB_MIN_ALIGN = 16;
+
+// slab 头部，位于 slab 起始地址
+struct SlabHeader {
+	SlabHeap* owner;
+	SlabHeader* prev;        // 空闲链表非空的 slab 组成的双向链表
+	SlabHeader* next;
+	void* freeList;          // slab 内的空闲对象（首个指针字段存下一个）
+	uint32_t freeCount;
+};
+static_assert(sizeof(SlabHeader) <= SLAB_HEADER_SIZE, "SlabHeader must fit in one cache line");
+
+// 每个线程、每个分配器一个堆
+struct SlabHeap {
+	SlabAllocator* allocator;
+	std::atomic<void*> remoteFree;   // 其他线程释放的对象（无锁栈，只有所属线程整体取走）
+	SlabHeader* partial;             // 有空闲对象的 slab
+	uint32_t slabCount;
+	uint32_t emptyCount;             // 完全空闲的 slab 数量
+	SlabHeap* nextAbandoned;
+
+	explicit SlabHeap(SlabAllocator* owner)
+		: allocator(owner), remoteFree(nullptr), partial(nullptr),
+		  slabCount(0), emptyCount(0), nextAbandoned(nullptr) {}
+
+	void LinkPartial(SlabHeader* slab) {
+		slab->prev = nullptr;
+		slab->next = partial;
+		if (partial) partial->prev = slab;
+		partial = slab;
+	}
+
+	void UnlinkPartial(SlabHeader* slab) {
+		if (slab->prev) slab->prev->next = slab->next;
+		else partial = slab->next;
+		if (slab->next) slab->next->prev = slab->prev;
+		slab->prev = slab->next = nullptr;
+	}
+
+	static void* AllocateSlabMemory() {
+#ifdef _WIN32
+		return _aligned_malloc(SlabAllocator::SLAB_SIZE, SlabAllocator::SLAB_SIZE);
+#else
+		void* memory = nullptr;
+		if (posix_memalign(&memory, SlabAllocator::SLAB_SIZE, SlabAllocator::SLAB_SIZE) != 0) return nullptr;
+		return memory;
+#endif
+	}
+
+	static void FreeSlabMemory(void* memory) {
+#ifdef _WIN32
+		_aligned_free(memory);
+#else
+		free(memory);
+#endif
+	}
+
+	bool NewSlab() {
+		void* memory = AllocateSlabMemory();
+		if (!memory) return false;
+
+		SlabHeader* slab = static_cast<SlabHeader*>(memory);
+		slab->owner = this;
+		slab->freeList = nullptr;
+		slab->freeCount = allocator->blocksPerSlab;
+
+		// 逆序串起空闲链表，分配时按地址递增取出
+		char* blocks = static_cast<char*>(memory) + SLAB_HEADER_SIZE;
+		for (uint32_t i = allocator->blocksPerSlab; i > 0; i--) {
+			void* block = blocks + (size_t)(i - 1) * allocator->stride;
+			*static_cast<void**>(block) = slab->freeList;
+			slab->freeList = block;
+		}
+
+		LinkPartial(slab);
+		slabCount++;
+		emptyCount++;
+		allocator->slabsCreated.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	void ReleaseSlab(SlabHeader* slab) {
+		UnlinkPartial(slab);
+		slabCount--;
+		FreeSlabMemory(slab);
+		allocator->slabsReleased.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void* AllocateLocal() {
+		SlabHeader* slab = partial;
+		if (slab->freeCount == allocator->blocksPerSlab) emptyCount--;
+
+		void* block = slab->freeList;
+		slab->freeList = *static_cast<void**>(block);
+		if (--slab->freeCount == 0) UnlinkPartial(slab);
+		return block;
+	}
+
+	void FreeLocal(SlabHeader* slab, void* block) {
+		*static_cast<void**>(block) = slab->freeList;
+		slab->freeList = block;
+		if (++slab->freeCount == 1) LinkPartial(slab);
+
+		if (slab->freeCount == allocator->blocksPerSlab) {
+			// 空闲 slab 超过上限时归还系统，缓存不会无限增长
+			if (emptyCount >= SlabAllocator::SLAB_KEEP_EMPTY) ReleaseSlab(slab);
+			else emptyCount++;
+		}
+	}
+
+	void PushRemote(void* block) {
+		void* head = remoteFree.load(std::memory_order_relaxed);
+		do {
+			*static_cast<void**>(block) = head;
+		} while (!remoteFree.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	void CollectRemote() {
+		void* block = remoteFree.exchange(nullptr, std::memory_order_acquire);
+		while (block) {
+			void* next = *static_cast<void**>(block);
+			FreeLocal(reinterpret_cast<SlabHeader*>(reinterpret_cast<uintptr_t>(block) & SLAB_MASK), block);
+			block = next;
+		}
+	}
+
+	// 线程退出：回收远程释放并归还所有空 slab；返回 true 表示堆已无 slab，可以删除
+	bool Abandon() {
+		CollectRemote();
+		SlabHeader* slab = partial;
+		while (slab) {
+			SlabHeader* next = slab->next;
+			if (slab->freeCount == allocator->blocksPerSlab) {
+				ReleaseSlab(slab);
+				emptyCount--;
+			}
+			slab = next;
+		}
+		return slabCount == 0;
+	}
+};
+
+// ====== 实例注册和线程局部堆 ======
+
+static SlabAllocator* g_slabAllocators[SlabAllocator::MAX_ALLOCATORS];
+static std::atomic<uint32_t> g_slabAllocatorCount(0);
+
+struct SlabThreadHeaps {
+	SlabHeap* heaps[SlabAllocator::MAX_ALLOCATORS];
+
+	SlabThreadHeaps() : heaps() {}
+
+	~SlabThreadHeaps() {
+		for (uint32_t i = 0; i < SlabAllocator::MAX_ALLOCATORS; i++) {
+			SlabHeap* heap = heaps[i];
+			if (!heap) continue;
+			heaps[i] = nullptr;
+
+			if (heap->Abandon()) {
+				delete heap;
+				continue;
+			}
+
+			// 仍有存活对象（可能被其他线程持有），挂到遗弃链表等待接管
+			SlabAllocator* allocator = heap->allocator;
+			std::lock_guard<std::mutex> lock(allocator->abandonMutex);
+			heap->nextAbandoned = allocator->abandoned;
+			allocator->abandoned = heap;
+			allocator->abandonedHeaps.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+};
+
+thread_local SlabThreadHeaps tlSlabHeaps;
+
+SlabAllocator::SlabAllocator(size_t objectSize)
+	: allocations(0), localFrees(0), remoteFrees(0),
+	  slabsCreated(0), slabsReleased(0), abandonedHeaps(0), abandoned(nullptr)
+{
+	if (objectSize < sizeof(void*)) objectSize = sizeof(void*);
+	stride = static_cast<uint32_t>((objectSize + SLAB_MIN_ALIGN - 1) & ~(size_t)(SLAB_MIN_ALIGN - 1));
+	assert(stride * 4 <= SLAB_SIZE - SLAB_HEADER_SIZE && "Object too large for slab");
+	blocksPerSlab = static_cast<uint32_t>((SLAB_SIZE - SLAB_HEADER_SIZE) / stride);
+
+	id = g_slabAllocatorCount.fetch_add(1, std::memory_order_relaxed);
+	assert(id < MAX_ALLOCATORS && "Too many slab allocators");
+	g_slabAllocators[id] = this;
+}
+
+SlabHeap* SlabAllocator::AdoptOrCreateHeap()
+{
+	{
+		std::lock_guard<std::mutex> lock(abandonMutex);
+		if (abandoned) {
+			SlabHeap* heap = abandoned;
+			abandoned = heap->nextAbandoned;
+			heap->nextAbandoned = nullptr;
+			abandonedHeaps.fetch_sub(1, std::memory_order_relaxed);
+			return heap;
+		}
+	}
+	return new (std::nothrow) SlabHeap(this);
+}
+
+SlabHeap* SlabAllocator::GetThreadHeap()
+{
+	SlabHeap*& heap = tlSlabHeaps.heaps[id];
+	if (!heap) heap = AdoptOrCreateHeap();
+	return heap;
+}
+
+void* SlabAllocator::Allocate()
+{
+	SlabHeap* heap = GetThreadHeap();
+	if (!heap) return nullptr;
+
+	if (!heap->partial) heap->CollectRemote();
+	if (!heap->partial && !heap->NewSlab()) return nullptr;
+
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	return heap->AllocateLocal();
+}
+
+void SlabAllocator::Free(void* ptr)
+{
+	if (!ptr) return;
+
+	SlabHeader* slab = reinterpret_cast<SlabHeader*>(reinterpret_cast<uintptr_t>(ptr) & SLAB_MASK);
+	SlabHeap* heap = slab->owner;
+
+	if (heap == tlSlabHeaps.heaps[id]) {
+		localFrees.fetch_add(1, std::memory_order_relaxed);
+		heap->FreeLocal(slab, ptr);
+	} else {
+		remoteFrees.fetch_add(1, std::memory_order_relaxed);
+		heap->PushRemote(ptr);
+	}
+}
+
+void SlabAllocator::GetStats(SlabAllocatorStats* stats) const
+{
+	if (!stats) return;
+
+	stats->allocations = allocations.load(std::memory_order_relaxed);
+	stats->localFrees = localFrees.load(std::memory_order_relaxed);
+	stats->remoteFrees = remoteFrees.load(std::memory_order_relaxed);
+	stats->slabsCreated = slabsCreated.load(std::memory_order_relaxed);
+	stats->slabsReleased = slabsReleased.load(std::memory_order_relaxed);
+	const uint64_t freed = stats->localFrees + stats->remoteFrees;
+	stats->liveObjects = stats->allocations > freed ? stats->allocations - freed : 0;
+	const uint64_t slabs = stats->slabsCreated > stats->slabsReleased ? stats->slabsCreated - stats->slabsReleased : 0;
+	stats->reservedBytes = slabs * SLAB_SIZE;
+	stats->abandonedHeaps = abandonedHeaps.load(std::memory_order_relaxed);
+}
+
+void SlabAllocator::GetTotalStats(SlabAllocatorStats* stats)
+{
+	if (!stats) return;
+
+	*stats = SlabAllocatorStats();
+	const uint32_t count = g_slabAllocatorCount.load(std::memory_order_acquire);
+	for (uint32_t i = 0; i < count && i < MAX_ALLOCATORS; i++) {
+		SlabAllocatorStats one;
+		g_slabAllocators[i]->GetStats(&one);
+		stats->allocations += one.allocations;
+		stats->localFrees += one.localFrees;
+		stats->remoteFrees += one.remoteFrees;
+		stats->slabsCreated += one.slabsCreated;
+		stats->slabsReleased += one.slabsReleased;
+		stats->liveObjects += one.liveObjects;
+		stats->reservedBytes += one.reservedBytes;
+		stats->abandonedHeaps += one.abandonedHeaps;
+	}
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+// 定长对象的 slab 分配器（每个线程一个堆）
+//
+// - 每个 slab 为 SLAB_SIZE 字节且按 SLAB_SIZE 对齐，对象地址向下对齐即可找到所属 slab
+// - 分配只访问当前线程的堆，无锁
+// - 本线程释放：直接放回 slab 的空闲链表
+// - 跨线程释放：压入所属堆的远程释放栈（无锁），所属线程下次分配时批量回收
+// - 完全空闲的 slab 每个堆最多保留 SLAB_KEEP_EMPTY 个，其余立即归还系统
+// - 线程退出时仍有存活对象的堆被挂到全局"遗弃"链表，由之后新建堆的线程接管
+
+struct SlabHeap;
+struct SlabThreadHeaps;
+
+// 分配器统计（所有 SlabAllocator 实例的合计见 SlabAllocator::GetTotalStats）
+struct SlabAllocatorStats {
+	uint64_t allocations;     // 累计分配次数
+	uint64_t localFrees;      // 累计本线程释放次数
+	uint64_t remoteFrees;     // 累计跨线程释放次数
+	uint64_t slabsCreated;    // 累计创建的 slab 数量
+	uint64_t slabsReleased;   // 累计归还系统的 slab 数量
+	uint64_t liveObjects;     // 当前存活对象数量
+	uint64_t reservedBytes;   // 当前 slab 占用的字节数
+	uint64_t abandonedHeaps;  // 当前等待接管的遗弃堆数量
+};
+
+class SlabAllocator {
+public:
+	static constexpr size_t SLAB_SIZE = 16 * 1024;
+	static constexpr uint32_t SLAB_KEEP_EMPTY = 2;
+	static constexpr uint32_t MAX_ALLOCATORS = 8;
+
+	explicit SlabAllocator(size_t objectSize);
+	~SlabAllocator() {}
+
+	void* Allocate();
+	void Free(void* ptr);
+
+	void GetStats(SlabAllocatorStats* stats) const;
+	// 所有实例的统计之和
+	static void GetTotalStats(SlabAllocatorStats* stats);
+
+	template<typename T>
+	T* New() {
+		void* p = Allocate();
+		return p ? new (p) T() : nullptr;
+	}
+
+	template<typename T>
+	void Delete(T* object) {
+		if (!object) return;
+		object->~T();
+		Free(object);
+	}
+
+private:
+	friend struct SlabHeap;
+	friend struct SlabThreadHeaps;
+
+	SlabHeap* GetThreadHeap();
+	SlabHeap* AdoptOrCreateHeap();
+
+	uint32_t id;
+	uint32_t stride;         // 对象步长（对齐到 16 字节）
+	uint32_t blocksPerSlab;
+
+	std::atomic<uint64_t> allocations;
+	std::atomic<uint64_t> localFrees;
+	std::atomic<uint64_t> remoteFrees;
+	std::atomic<uint64_t> slabsCreated;
+	std::atomic<uint64_t> slabsReleased;
+	std::atomic<uint64_t> abandonedHeaps;
+	std::mutex abandonMutex;
+	SlabHeap* abandoned;     // 遗弃堆链表（由 abandonMutex 保护）
+
+	SlabAllocator(const SlabAllocator&) = delete;
+	SlabAllocator& operator=(const SlabAllocator&) = delete;
+};
+
+// 单一类型的对象池（进程内单例，任意线程都可以分配和归还）
+template<typename T>
+class SlabObjectPool {
+private:
+	SlabAllocator slab;
+
+public:
+	SlabObjectPool() : slab(sizeof(T)) {}
+
+	T* Allocate() { return slab.New<T>(); }
+	void Free(T* object) { slab.Delete(object); }
+	void GetStats(SlabAllocatorStats* stats) const { slab.GetStats(stats); }
+
+	static SlabObjectPool& GetInstance() {
+		static SlabObjectPool instance;
+		return instance;
+	}
+};
@@ -0,0 +1,120 @@
+#pragma once
+#include "JobSystem.h"
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// 结构化 fork-join：TaskGroup 派生一组子任务并在离开作用域前等待它们全部完成
+//
+// - 最后一次 Spawn 的任务不入队，而是在 Wait 时由当前线程直接执行
+//   （二分递归时每层只有一半任务经过队列）
+// - 闭包放在当前线程的 Job 级临时内存里（AllocJobScratch），不做堆分配；
+//   Wait 返回时只有在最后一次 Spawn 之后本线程没有再申请（后进先出）才回退到第一次 Spawn 之前，
+//   否则后面的申请（其他组的闭包、调用方的数据）可能还在使用，留到当前 Job 返回时一起回收
+// - 在 Job 内创建时，组的根 Job 是当前 Job 的子 Job：取消向下传递，
+//   Wait 采用 JOB_WAIT_HELP_SUBTREE，只协助执行本组（及嵌套组）的任务
+
+template<typename Func>
+void TaskGroupJob(Job* job, void* jobData) {
+    Func* func = static_cast<Func*>(jobData);
+    // 已取消：跳过闭包，但仍要析构
+    if (!JobSystem::IsCancelled(job)) {
+        (*func)();
+    }
+    func->~Func();
+}
+
+class TaskGroup {
+public:
+    explicit TaskGroup(JobSystem* jobSystem) : jobSystem(jobSystem), root(nullptr), deferred(nullptr), scratchMarker(), scratchEnd() {}
+    ~TaskGroup() { Wait(); }
+
+    // 派生任务 func()；在调用 Wait（或析构）之前可能尚未开始
+    template<typename Func>
+    void Spawn(Func&& func) {
+        typedef typename std::decay<Func>::type FuncType;
+        if (!root) {
+            Job* parent = JobSystem::GetCurrentJob();
+            root = parent ? jobSystem->CreateJob(parent, EmptyJob) : jobSystem->CreateJob(EmptyJob);
+            scratchMarker = JobSystem::GetJobScratchMarker();
+        }
+
+        void* storage = JobSystem::AllocJobScratch(sizeof(FuncType), alignof(FuncType));
+        Job* job = jobSystem->CreateJob(root, TaskGroupJob<FuncType>);
+        job->data = new (storage) FuncType(std::forward<Func>(func));
+        job->flags.fetch_or(JOB_FLAG_RUN_ON_CANCEL, std::memory_order_relaxed);
+        scratchEnd = JobSystem::GetJobScratchMarker();
+
+        // 上一个推迟的任务入队，本任务留给 Wait 内联执行
+        if (deferred) {
+            jobSystem->RunJob(deferred);
+        }
+        deferred = job;
+    }
+
+    // 执行推迟的任务并等待所有任务完成，之后可以继续 Spawn
+    void Wait() {
+        if (!root) {
+            return;
+        }
+        if (deferred) {
+            Job* job = deferred;
+            deferred = nullptr;
+            jobSystem->RunJobInline(job);
+        }
+
+        jobSystem->RunJob(root);
+        JobWaitOptions options;
+        options.policy = JOB_WAIT_HELP_SUBTREE;
+        options.timeoutMicros = 0;
+        options.budgetMicros = 0;
+        options._padding = 0;
+        jobSystem->WaitAll(&root, 1, options);
+        root = nullptr;
+
+        // 协助执行的 Job 返回时各自回退，这里看到的仍是本组最后一次 Spawn 之后的位置才说明没有更新的申请
+        const ScratchArena::Marker current = JobSystem::GetJobScratchMarker();
+        if (current.block == scratchEnd.block && current.used == scratchEnd.used) {
+            JobSystem::ResetJobScratch(scratchMarker);
+        }
+    }
+
+    // 取消尚未开始的任务（正在执行的任务可以轮询 JobSystem::IsCancelled(job)）
+    void Cancel() {
+        if (root) {
+            jobSystem->CancelJob(root);
+        }
+    }
+
+private:
+    static void EmptyJob(Job*, void*) {
+        // 空的根作业，只用于等待所有子作业完成
+    }
+
+    JobSystem* jobSystem;
+    Job* root;
+    Job* deferred;
+    ScratchArena::Marker scratchMarker;   // 第一次 Spawn 之前
+    ScratchArena::Marker scratchEnd;      // 最后一次 Spawn 之后
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+};
+
+// parallel_invoke 的展开：除最后一个外依次 Spawn，最后一个同样由 Wait 内联执行
+inline void parallel_invoke_spawn(TaskGroup&) {}
+
+template<typename Func, typename... Rest>
+void parallel_invoke_spawn(TaskGroup& group, Func&& func, Rest&&... rest) {
+    group.Spawn(std::forward<Func>(func));
+    parallel_invoke_spawn(group, std::forward<Rest>(rest)...);
+}
+
+// 并行执行 funcs...，全部完成后返回
+template<typename... Funcs>
+void parallel_invoke(JobSystem* jobSystem, Funcs&&... funcs) {
+    TaskGroup group(jobSystem);
+    parallel_invoke_spawn(group, std::forward<Funcs>(funcs)...);
+    group.Wait();
+}
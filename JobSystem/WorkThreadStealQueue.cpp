@@ -1,4 +1,5 @@
 #include "WorkThreadStealQueue.h"
+#include <algorithm>
 #include <atomic>
 
 #define COMPILER_BARRIER std::atomic_signal_fence(std::memory_order_seq_cst)
@@ -85,4 +86,53 @@ Job* WorkThreadStealQueue::Steal() {
         // empty queue
         return nullptr;
     }
-}
\ No newline at end of file
+}
+
+void SharedJobQueue::Push(Job* job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.push_back(job);
+    count.fetch_add(1, std::memory_order_release);
+    pushCount.fetch_add(1, std::memory_order_release);
+}
+
+Job* SharedJobQueue::Pop() {
+    if (Empty()) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (jobs.empty()) {
+        return nullptr;
+    }
+    Job* job = jobs.front();
+    jobs.pop_front();
+    count.fetch_sub(1, std::memory_order_release);
+    return job;
+}
+
+static bool LowerPriority(const Job* a, const Job* b) {
+    return a->priority < b->priority;
+}
+
+void PriorityJobQueue::Push(Job* job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    heap.push_back(job);
+    std::push_heap(heap.begin(), heap.end(), LowerPriority);
+    count.fetch_add(1, std::memory_order_release);
+}
+
+Job* PriorityJobQueue::Pop() {
+    if (Empty()) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (heap.empty()) {
+        return nullptr;
+    }
+    std::pop_heap(heap.begin(), heap.end(), LowerPriority);
+    Job* job = heap.back();
+    heap.pop_back();
+    count.fetch_sub(1, std::memory_order_release);
+    return job;
+}
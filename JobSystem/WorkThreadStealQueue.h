@@ -1,5 +1,8 @@
-#pragma 
+#pragma once
 #include <mutex>
+#include <deque>
+#include <vector>
+#include <atomic>
 #include "Job.h"
 
 static const unsigned int MAX_NUMBER_OF_JOBS_PERTTHREAD = 4096u;
@@ -15,4 +18,55 @@ public:
 	void Push(Job* job);
 	Job* Pop();
 	Job* Steal();
-};
\ No newline at end of file
+	// 近似长度（无同步，只用于调度决策）
+	long Size() const { long size = m_bottom - m_top; return size > 0 ? size : 0; }
+};
+
+// 多生产者多消费者的加锁 FIFO 队列，用于不参与窃取的专用通道（如主线程队列）
+class SharedJobQueue {
+private:
+	std::mutex mutex;
+	std::deque<Job*> jobs;
+	std::atomic<size_t> count;
+	std::atomic<uint64_t> pushCount;
+public:
+	SharedJobQueue() : count(0), pushCount(0) {}
+	void Push(Job* job);
+	Job* Pop();
+	// 取出第一个满足 match(job) 的 Job（线性扫描，只用于很短的队列）
+	template<typename Match>
+	Job* PopMatching(Match match) {
+		if (Empty()) {
+			return nullptr;
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		for (std::deque<Job*>::iterator it = jobs.begin(); it != jobs.end(); ++it) {
+			if (match(*it)) {
+				Job* job = *it;
+				jobs.erase(it);
+				count.fetch_sub(1, std::memory_order_release);
+				return job;
+			}
+		}
+		return nullptr;
+	}
+	// 无锁的近似判空，供轮询路径快速跳过
+	bool Empty() const { return count.load(std::memory_order_acquire) == 0; }
+	size_t Size() const { return count.load(std::memory_order_relaxed); }
+	// 累计入队次数：没有变化说明上次扫描之后没有新 Job 进入
+	uint64_t PushCount() const { return pushCount.load(std::memory_order_acquire); }
+};
+
+// 按 Job::priority 取最大值的加锁优先队列（二叉堆），所有线程共享，用于关键路径调度
+class PriorityJobQueue {
+private:
+	std::mutex mutex;
+	std::vector<Job*> heap;
+	std::atomic<size_t> count;
+public:
+	PriorityJobQueue() : count(0) {}
+	void Push(Job* job);
+	Job* Pop();
+	bool Empty() const { return count.load(std::memory_order_acquire) == 0; }
+	size_t Size() const { return count.load(std::memory_order_relaxed); }
+};
@@ -2,8 +2,19 @@
 #include <chrono>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
 #include "JobSystem.h"
 #include "ParallelFor.h"
+#include "TaskGroup.h"
+#include "ParallelPipeline.h"
+#include "JobGraph.h"
+#include "ParallelMemory.h"
+#include "ParticleSnapshot.h"
 
 // 测试Job函数：简单计算任务
 void SimpleTask(Job* job, void* data) {
@@ -37,7 +48,296 @@ struct FrameStats {
     int jobCount;
 };
 
-int main() {
+// ====== 功能检查 ======
+// 每项检查创建自己的 JobSystem（固定 4 个线程），失败时 main 返回非 0
+
+static int g_checkFailures = 0;
+
+static void Check(bool condition, const char* name) {
+    std::cout << (condition ? "  [PASS] " : "  [FAIL] ") << name << std::endl;
+    if (!condition) g_checkFailures++;
+}
+
+static JobSystemConfig CheckConfig() {
+    JobSystemConfig config = JobSystem::DefaultConfig();
+    config.numThreads = 4;
+    return config;
+}
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void SleepTask(Job*, void* data) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(reinterpret_cast<intptr_t>(data)));
+}
+
+static void SpinTask(Job*, void* data) {
+    const auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(reinterpret_cast<intptr_t>(data));
+    while (std::chrono::steady_clock::now() < end) {}
+}
+
+// HELP_BUDGET：等待短 Job 时不能接手无关的长 Job（没有耗时历史的 Job 按超出预算处理）
+static void CheckWaitBudget() {
+    JobSystem jobSystem;
+    jobSystem.Initialize(CheckConfig());
+
+    // 短 Job 先入队、长 Job 后入队：主线程从自己的队列先取到长 Job
+    Job* shortJob = jobSystem.CreateJob(SpinTask);
+    shortJob->data = reinterpret_cast<void*>(static_cast<intptr_t>(200));
+    Job* longJob = jobSystem.CreateJob(SleepTask);
+    longJob->data = reinterpret_cast<void*>(static_cast<intptr_t>(100));
+    jobSystem.RunJob(shortJob);
+    jobSystem.RunJob(longJob);
+
+    JobWaitOptions options = jobSystem.DefaultWaitOptions();
+    options.policy = JOB_WAIT_HELP_BUDGET;
+    options.budgetMicros = 1000;
+    const auto start = std::chrono::steady_clock::now();
+    jobSystem.WaitAll(&shortJob, 1, options);
+    Check(MillisecondsSince(start) < 50.0, "HELP_BUDGET wait does not pick up a long unrelated job");
+
+    jobSystem.WaitJob(longJob);
+    jobSystem.ShutDown();
+}
+
+static void EmptyTask(Job*, void*) {
+}
+
+// 带超时的 WaitAll / WaitAny / BLOCK：被等待的 Job 有一个尚未提交的子 Job，超时前不可能完成
+static void CheckWaitTimeouts() {
+    JobSystem jobSystem;
+    jobSystem.Initialize(CheckConfig());
+
+    Job* pending = jobSystem.CreateJob(EmptyTask);
+    Job* child = jobSystem.CreateJob(pending, EmptyTask);
+    Job* quick = jobSystem.CreateJob(EmptyTask);
+    jobSystem.RunJob(pending);
+    jobSystem.RunJob(quick);
+
+    JobWaitOptions options = jobSystem.DefaultWaitOptions();
+    options.timeoutMicros = 10000;
+    auto start = std::chrono::steady_clock::now();
+    const bool all = jobSystem.WaitAll(&pending, 1, options);
+    Check(!all && MillisecondsSince(start) < 1000.0, "WaitAll times out");
+
+    Job* either[2] = { pending, quick };
+    Check(jobSystem.WaitAny(either, 2, options) == 1, "WaitAny returns the completed job");
+
+    options.policy = JOB_WAIT_BLOCK;
+    start = std::chrono::steady_clock::now();
+    const bool blocked = jobSystem.WaitAll(&pending, 1, options);
+    Check(!blocked && MillisecondsSince(start) < 1000.0, "BLOCK wait times out");
+
+    jobSystem.RunJob(child);
+    options.timeoutMicros = 0;
+    Check(jobSystem.WaitAll(&pending, 1, options), "BLOCK wait completes once the child runs");
+    jobSystem.ShutDown();
+}
+
+// TaskGroup 嵌套：递归 fork-join 计算斐波那契数
+static JobSystem* g_taskGroupSystem = nullptr;
+
+static long TaskGroupFib(int n) {
+    if (n < 12) {
+        return n < 2 ? n : TaskGroupFib(n - 1) + TaskGroupFib(n - 2);
+    }
+    long x = 0;
+    long y = 0;
+    TaskGroup group(g_taskGroupSystem);
+    group.Spawn([&x, n] { x = TaskGroupFib(n - 1); });
+    group.Spawn([&y, n] { y = TaskGroupFib(n - 2); });
+    group.Wait();
+    return x + y;
+}
+
+static void CheckTaskGroup() {
+    JobSystem jobSystem;
+    jobSystem.Initialize(CheckConfig());
+    g_taskGroupSystem = &jobSystem;
+
+    jobSystem.FrameStart();
+    const long fib = TaskGroupFib(20);
+    jobSystem.FrameEnd();
+    Check(fib == 6765, "nested TaskGroup fork-join");
+
+    g_taskGroupSystem = nullptr;
+    jobSystem.ShutDown();
+}
+
+// parallel_pipeline：并行级打乱完成顺序，按序串行级仍按输入顺序输出
+static void CheckPipeline() {
+    JobSystem jobSystem;
+    jobSystem.Initialize(CheckConfig());
+
+    const intptr_t ITEM_COUNT = 2000;
+    intptr_t next = 1;
+    std::vector<intptr_t> output;
+    ParallelPipeline pipeline;
+    pipeline.AddStage(JOB_PIPELINE_SERIAL_IN_ORDER, [&next, ITEM_COUNT](void*) -> void* {
+        return next <= ITEM_COUNT ? reinterpret_cast<void*>(next++) : nullptr;
+    });
+    pipeline.AddStage(JOB_PIPELINE_PARALLEL, [](void* item) -> void* {
+        // 奇数项多做一些工作
+        if (reinterpret_cast<intptr_t>(item) % 2) {
+            volatile int sum = 0;
+            for (int i = 0; i < 2000; i++) sum += i;
+        }
+        return item;
+    });
+    pipeline.AddStage(JOB_PIPELINE_SERIAL_IN_ORDER, [&output](void* item) -> void* {
+        output.push_back(reinterpret_cast<intptr_t>(item));
+        return item;
+    });
+    parallel_pipeline(&jobSystem, 8, pipeline);
+
+    bool ordered = output.size() == static_cast<size_t>(ITEM_COUNT);
+    for (size_t i = 0; ordered && i < output.size(); i++) {
+        ordered = output[i] == static_cast<intptr_t>(i + 1);
+    }
+    Check(ordered, "parallel_pipeline in-order stage output");
+    jobSystem.ShutDown();
+}
+
+// JobGraph：每个节点记录执行次序，依赖的节点必须先执行
+static std::atomic<int> g_graphClock(0);
+
+static void GraphNodeTask(Job*, void* data) {
+    *static_cast<int*>(data) = ++g_graphClock;
+}
+
+static void CheckJobGraph() {
+    JobSystem jobSystem;
+    JobSystemConfig config = CheckConfig();
+    config.criticalPathScheduling = 1;
+    jobSystem.Initialize(config);
+
+    // 菱形 a -> (b, c) -> d，再加一条 a -> e -> f -> d 的链
+    int stamps[6] = {};
+    JobGraph graph;
+    JobGraph::NodeId nodes[6];
+    for (int i = 0; i < 6; i++) {
+        nodes[i] = graph.AddNode(GraphNodeTask, &stamps[i]);
+    }
+    const int edges[][2] = { { 0, 1 }, { 0, 2 }, { 1, 3 }, { 2, 3 }, { 0, 4 }, { 4, 5 }, { 5, 3 } };
+    for (const auto& edge : edges) {
+        graph.AddDependency(nodes[edge[0]], nodes[edge[1]]);
+    }
+
+    bool ordered = graph.Compile();
+    for (int round = 0; ordered && round < 20; round++) {
+        g_graphClock = 0;
+        jobSystem.FrameStart();
+        Job* root = graph.Launch(jobSystem);
+        jobSystem.RunJob(root);
+        jobSystem.WaitJob(root);
+        jobSystem.FrameEnd();
+        for (const auto& edge : edges) {
+            ordered = ordered && stamps[edge[0]] > 0 && stamps[edge[0]] < stamps[edge[1]];
+        }
+    }
+    Check(ordered, "JobGraph dependency order");
+
+    JobGraph cyclic;
+    const JobGraph::NodeId a = cyclic.AddNode(GraphNodeTask, &stamps[0]);
+    const JobGraph::NodeId b = cyclic.AddNode(GraphNodeTask, &stamps[1]);
+    cyclic.AddDependency(a, b);
+    cyclic.AddDependency(b, a);
+    Check(!cyclic.Compile(), "JobGraph rejects cycles");
+    jobSystem.ShutDown();
+}
+
+// 粒子快照：压缩 / 不压缩各保存一次，恢复后逐字节比较
+static void CheckParticleSnapshot() {
+    JobSystem jobSystem;
+    jobSystem.Initialize(CheckConfig());
+
+    const uint32_t PARTICLE_COUNT = 40000;   // 跨 3 个分块，最后一块不满
+    std::vector<ParticleData> particles(PARTICLE_COUNT);
+    SimpleRandom rng(7);
+    for (ParticleData& particle : particles) {
+        SpawnParticle(particle, rng);
+    }
+    PhysicsParams params = PhysicsParams();
+    params.deltaTime = 0.016f;
+    params.baseSeed = 42;
+
+    const char* path = "JobSystemCheck.psnap";
+    for (uint32_t flags = 0; flags <= PARTICLE_SNAPSHOT_COMPRESS; flags += PARTICLE_SNAPSHOT_COMPRESS) {
+        bool ok = JobSystem_SaveParticleSnapshot(&jobSystem, path, particles.data(), PARTICLE_COUNT, &params, flags) == PARTICLE_SNAPSHOT_OK;
+        ParticleSnapshot* snapshot = ok ? ParticleSnapshot_Open(path, nullptr) : nullptr;
+        std::vector<ParticleData> restored(PARTICLE_COUNT);
+        PhysicsParams restoredParams;
+        ok = snapshot && ParticleSnapshot_GetCount(snapshot) == PARTICLE_COUNT &&
+            JobSystem_VerifyParticleSnapshot(&jobSystem, snapshot) == PARTICLE_SNAPSHOT_OK &&
+            JobSystem_RestoreParticleSnapshot(&jobSystem, snapshot, restored.data(), PARTICLE_COUNT) == PARTICLE_SNAPSHOT_OK &&
+            memcmp(restored.data(), particles.data(), PARTICLE_COUNT * sizeof(ParticleData)) == 0;
+        if (snapshot) {
+            ParticleSnapshot_GetParams(snapshot, &restoredParams);
+            ok = ok && memcmp(&restoredParams, &params, sizeof(params)) == 0;
+            // 不压缩时可以直接映射
+            ok = ok && (flags != 0 || (ParticleSnapshot_MapParticles(snapshot) &&
+                memcmp(ParticleSnapshot_MapParticles(snapshot), particles.data(), PARTICLE_COUNT * sizeof(ParticleData)) == 0));
+            ParticleSnapshot_Close(snapshot);
+        }
+        Check(ok, flags ? "particle snapshot round trip (compressed)" : "particle snapshot round trip (uncompressed)");
+    }
+    remove(path);
+    jobSystem.ShutDown();
+}
+
+// ParallelCopy / ParallelFill：流式写入阈值两侧，目标不对齐，检查边界外的字节未被改写
+static void CheckParallelMemory() {
+    JobSystem jobSystem;
+    jobSystem.Initialize(CheckConfig());
+
+    const size_t sizes[] = { PARALLEL_MEMORY_STREAMING_THRESHOLD - 1, PARALLEL_MEMORY_STREAMING_THRESHOLD,
+        PARALLEL_MEMORY_STREAMING_THRESHOLD + 4097 };
+    const size_t GUARD = 64;
+    bool copyOk = true;
+    bool fillOk = true;
+    for (size_t bytes : sizes) {
+        std::vector<uint8_t> src(bytes + GUARD);
+        for (size_t i = 0; i < src.size(); i++) src[i] = static_cast<uint8_t>(i * 31 + 7);
+        std::vector<uint8_t> dst(bytes + 2 * GUARD, 0xAA);
+        std::vector<uint8_t> expected(dst);
+
+        Job* copy = ParallelCopy(jobSystem, dst.data() + GUARD + 3, src.data() + 1, bytes);
+        jobSystem.RunJob(copy);
+        jobSystem.WaitJob(copy);
+        memcpy(expected.data() + GUARD + 3, src.data() + 1, bytes);
+        copyOk = copyOk && dst == expected;
+
+        Job* fill = ParallelFill(jobSystem, dst.data() + GUARD + 5, 0x5C, bytes - 8);
+        jobSystem.RunJob(fill);
+        jobSystem.WaitJob(fill);
+        memset(expected.data() + GUARD + 5, 0x5C, bytes - 8);
+        fillOk = fillOk && dst == expected;
+    }
+    Check(copyOk, "ParallelCopy around the streaming threshold");
+    Check(fillOk, "ParallelFill around the streaming threshold");
+    jobSystem.ShutDown();
+}
+
+static int RunChecks() {
+    std::cout << "=== Checks ===" << std::endl;
+    CheckWaitBudget();
+    CheckWaitTimeouts();
+    CheckTaskGroup();
+    CheckPipeline();
+    CheckJobGraph();
+    CheckParticleSnapshot();
+    CheckParallelMemory();
+    std::cout << (g_checkFailures == 0 ? "All checks passed." : "Some checks FAILED.") << std::endl;
+    return g_checkFailures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    // --checks：只运行功能检查（ctest 使用）
+    if (argc > 1 && std::string(argv[1]) == "--checks") {
+        return RunChecks();
+    }
+
     std::cout << "=== JobSystem Test ===" << std::endl;
 
     // 初始化JobSystem